@@ -3,13 +3,25 @@
 
     A library that knows how to talk to a TLC5926/TLC5927 (16-bit shift-register).
 
-    * Supports "slow" (digitalWrite / shiftOut) mode (non-SPI).
+    * Supports "slow" (bit-bang, non-SPI) mode. On AVR, the pins are written straight to their port registers (looked up once at attach).
+    * TLC5926Fixed<SDI, CLK, LE, iOE, SDO> for pins known at compile time: no branches for unused lines (TLC5926Fixed.h).
+    * TLC5926Multi drives up to 8 chains that share CLK, LE and /OE, with all their SDI's on one port: one port write per clock feeds every chain (TLC5926Multi.h).
+    * TLC5926Group updates several TLC5926 objects that share CLK (and LE, /OE) in one interleaved pass, with one latch (TLC5926Group.h).
+    * Supports hardware SPI for the data (SDI->MOSI, CLK->SCK), see attach_spi().
     * The global brightness feature uses PWM, so is not blocking (requires iOE pin).
+    * Gamma-corrected global brightness, 12-bit on a Timer1 pin, with background fades (TLC5926Dimmer.h).
+    * Non-blocking double-buffered frames: the chain is shifted from a timer interrupt, and latched when done.
+    * Per-channel brightness in the background, by binary code modulation on a timer interrupt (TLC5926BCM.h).
+    * Multiplexed LED matrices: the chain drives the columns, scanned row by row on a timer interrupt, with optional per-pixel brightness (TLC5926Matrix.h).
+    * Pattern tables (chase, bounce, fill, mirrored, rewired...) generated at compile time into PROGMEM (TLC5926Patterns.h).
+    * Compact animations (keyframes, XOR deltas, run-length coded) played from PROGMEM or a Stream without blocking (TLC5926Anim.h, extras/anim_encode.py).
+    * Frames from a host over Serial (any Stream), shifted into the chain as they arrive, latched only if the checksum is good (TLC5926Receiver.h, extras/send_frames.py).
     * Knows that /OE is inverted.
-    * Should work for TLC5916/TLC5917: just divide the "number chained together" in half.
-        And, the patterns are 2 shift-registers wide.
-    * Can get the diagnostic-mode info (short/open/over-temp).
-    * Can set the current-gain value.
+    * Works for TLC5916/TLC5917, and chains that mix them with TLC5926/TLC5927: see chip_widths().
+    * Boards wired out of order, or chips mounted backwards: channel_map() keeps set()/frames in your order, translated as they shift (nibble lookup tables).
+    * Can check every frame as it shifts, against what comes back out of SDO (verify()).
+    * Can get the diagnostic-mode info (short/open/over-temp), for every chip in the chain in one pass.
+    * Can set the current-gain value, per chip. Setting the same value again does nothing (no mode-switch).
 
     Supports 2-4 signal lines (with appropriate "pull-down" resistors):
 
@@ -21,7 +33,7 @@
     * No Flicker -- SDI + CLK + LE
         * no flickering during shifting -- data is not visible until end-of-pattern
         * assumes /OE->GND
-        * no brigtness control (roll your own blocking pwm)
+        * no global brigtness control, but per-channel brightness works (TLC5926BCM)
     * Master-Power/better-pwm (OE) -- SDI + CLK + LE + /OE
         * can turn the whole shift-register chain on/off with one bit
         * brightness control
@@ -60,18 +72,38 @@
 
     ### Stupid Tricks
 
-    The diagnostic function can be used to get 16 digital inputs! Put a switch on one or more of the TLC's output-channels. The diagnostic result will tell you if an output-channel is open or closed. Obviously, anything that provides a digital value can be used: reading signals that rely on timing would be difficult. You should be able to sample the whole TLC at a fairly high rate. You can even mix input/outputs: put some LEDs on some, some switches on others.
+    The diagnostic function can be used to get 16 digital inputs! Put a switch on one or more of the TLC's output-channels. The diagnostic result will tell you if an output-channel is open or closed. Obviously, anything that provides a digital value can be used: reading signals that rely on timing would be difficult. You should be able to sample the whole TLC at a fairly high rate. You can even mix input/outputs: put some LEDs on some, some switches on others. TLC5926Scanner (TLC5926Scanner.h) does it in the background: the chain stays in error-detect mode, sampled on a timer, debounced, with a change list.
 
     By combining outputs, you might be able to run motors or servos. While the TLC provides up to 120ma, that's rarely enough to _start_ even small motors. Motors take a surge of current to start, something like 5 times their running current or more. So, hook 3 or more outputs together to power the motor, and turn them all on/off together. You'll want to use the LE signal.
 
     Similarly, you could power big things by combining outputs.
 
-    In the future: SPI (hardware interface) mode, 
+    ### SPI (hardware interface) mode
+
+    attach_spi() puts SDI on the MOSI pin and CLK on the SCK pin, and shift()/send()/all() push whole bytes through the SPI peripheral (MHz instead of a few hundred kHz). LE, /OE and SDO are still plain pins, and work the same as before. The mode-switching, config(), error_detect() and send_bits() still bit-bang, so the library takes SCK/MOSI back from the SPI peripheral for those, and hands them back at the next shift.
 
     > * SPI mode assumes that you have a setup that can handle the high-frequency
     > * signals to the TLC5926. That usually means decoupling caps (1muf) on the
     > * signal lines (near the TLC5926).
 
+    The SPI part is in its own header, so sketches that only bit-bang don't pull in the SPI library. For attach_spi(), include it in your sketch:
+
+        #include <TLC5926SPI.h> // brings in SPI.h
+        #include <TLC5926.h>
+
+    ### Timer interrupt
+
+    send_async()/flush_async(), TLC5926BCM, TLC5926Matrix, TLC5926Scanner and TLC5926Dimmer's dither run on Timer1 (AVR), through TLC5926Timer. The interrupt vector is only there if the sketch asks for it, so the library doesn't collide with Servo (etc.) when it's not needed. Include it in one file:
+
+        #include <TLC5926TimerISR.h> // Timer1's compare-match and overflow vectors
+        #include <TLC5926.h>
+
+    Without it, they fall back to being driven from your own timer: call async_step() / the engine's isr() / tick(). send_async() also gets along without: async_done() (and anything that waits for the frame) shifts the next chunk itself.
+
+    ## Tests
+
+    `make test` builds the library on Linux, against a stand-in Arduino core and a model of the chain (test/TLC5926Sim.h): shift registers, latches, /OE, mode switches and SDO, per the datasheet. The tests check what ends up in the chips, and count the edges it took. Built twice: with digitalWrite(), and with port registers like AVR. `make bench` prints timings as CSV: edges, simulated time (about an Uno's) and host time per operation.
+
 */
 
 /* # Use:
@@ -92,12 +124,22 @@
 
             // turn on warnings. probably turn it off when in production
             shift_register1.debug(1); // requires Serial.begin(...);
+            // For production, compile the messages out completely: TLC5926_LOG_LEVEL 0 in TLC5926.h
+            // Or, keep them in a RAM trace (TLC5926_TRACE), and TLC5926::dump_trace(Serial) when you want to see them
+            // How much time goes where: TLC5926_STATS 1 (in TLC5926.h, or -D), then shift_register1.stats().send_max_us, .clocks, etc.
 
             // LE_pin and iOE_pin would be -1 if not hooked up
             shift_register1.attach(1, SDI_pin, CLK_pin, LE_pin, iOE_pin ); // attach 1 shift-register, "1" is optional
             
             // A second shift_register obviously would be on different pins
 
+            // Or, use the hardware SPI for SDI/CLK (MOSI/SCK), 4MHz is the default clock (#include <TLC5926SPI.h>)
+            // shift_register2.attach_spi(24, LE_pin, iOE_pin, -1, 8000000);
+
+            // A chain that mixes TLC5916's (8 bits) and TLC5926's: say which is which, first chip first
+            // const byte widths[] = { 8, 16, 16 };
+            // shift_register3.attach(3, ...)->chip_widths(widths, 3); // 40 channels, no padding
+
             // nice to set everything off/clear at first
             // otherwise, leaves the tlc5926 with whatever data it had, and powering outputs
             shift_register1.off();
@@ -153,6 +195,22 @@
                 shift_register1.send( 0b00000000 ); delay(animate_delay);
                 }
 
+            // Or, keep a framebuffer of the whole chain, and flush it
+            // Channel 0 is OUT0 of the first chip (nearest the arduino)
+            shift_register1.set(0)->set(17)->toggle(5)->clear(1);
+            shift_register1.set_word(1, 0xF00F); // 2nd chip
+            shift_register1.flush(); // shifts the whole chain, one latch
+            shift_register1.flush(); // nothing changed, so does nothing
+            // With SDO hooked up: check the chain as it shifts, e.g. to find the fastest clock that still works
+            // shift_register1.verify(true); ... flush()/send()/all() ...
+            // if (!shift_register1.verified()) Serial.println(shift_register1.bit_errors());
+            shift_register1.scroll(1, HIGH); // marquee: clocks in just 1 bit, everything moves up a channel
+
+            // Or, in the background (on a timer interrupt, see TLC5926TimerISR.h), then build the next one meanwhile
+            shift_register1.flush_async();
+            shift_register1.set(3);
+            while (!shift_register1.async_done()) ; // or check it next time through loop()
+
             // Send data and control the latch yourself
             // (assume LE is low)
             shift_register1.shift(0x0808); // 
@@ -167,6 +225,13 @@
                 ->send( 0b0011001100110011 )->delay(500)
                 ->all(LOW)
                 ;
+
+            // Non-blocking: the same chain, but queued, and run by update()
+            // (e.g. TLC5926Step steps[16]; shift_register1.defer(steps, 16); in setup())
+            if (!shift_register1.busy()) {
+                shift_register1.all(HIGH)->delay(100)->send( 0b0011001100110011 )->flash()->all(LOW);
+                }
+            shift_register1.update(); // every time through loop()
             }
 */
 
@@ -182,6 +247,43 @@ TLC5926::TLC5926() {
     SDO = -1;
     ct = 0; // use this as the signal for attached
     pwm = false; // is iOE on pwm?
+    ioe_level = 0;
+    spi = false;
+    spi_live = false;
+    spi_clock = 0;
+    fb = NULL;
+    fb_dirty = true; // don't know what the chain has
+    queue = NULL;
+    queue_len = queue_head = queue_ct = 0;
+    replaying = false;
+    waiting = false;
+    wait_us = false;
+    wait_start = wait_for = 0;
+    now_ms = millis;
+    now_us = micros;
+    shifted_all_on = latched_all_on = false;
+    detect_was_replaying = false;
+    detect_held = false;
+    configs = NULL;
+    widths = NULL;
+    width_total = 0;
+    reset_stats();
+    remap = NULL;
+    mirrored = NULL;
+    verifying = false;
+    verify_ring = NULL;
+    verify_head = verify_ct = 0;
+    verify_compared = verify_ok = false;
+    verify_frame_errors = 0;
+    verify_errors = 0;
+    configs_known = false;
+    shadow = NULL;
+    async_at = 0;
+    async_busy = false;
+    async_timed = false;
+    async_period_us = 100;
+    async_chunk = 2;
+    async_done_fn = NULL;
     debugging = false;
     }
 
@@ -191,6 +293,23 @@ int TLC5926::LE_pin() { return LE; }
 int TLC5926::iOE_pin() { return iOE; }
 int TLC5926::SDO_pin() { return SDO; }
 
+TLC5926::~TLC5926() {
+    // the isr would go on shifting out of freed memory
+    noInterrupts();
+    if (async_running == this) {
+        if (async_timed) timer_stop();
+        async_running = NULL;
+        }
+    interrupts();
+    free(fb);
+    free(shadow);
+    free(verify_ring);
+    free(configs);
+    free(widths);
+    free(remap);
+    free(mirrored);
+    }
+
 TLC5926* TLC5926::debug(boolean v) { debugging = v; return this; }
 
 void TLC5926::debug_print(const char * msg ) {
@@ -198,6 +317,36 @@ void TLC5926::debug_print(const char * msg ) {
     Serial.println(msg);
     }
 
+#if TLC5926_STATS
+#define TLC5926_COUNT(field, n) (counters.field += (n))
+#define TLC5926_TIME_START() unsigned long stats_start = micros()
+#define TLC5926_TIME(field) stats_time(counters.field##_us, counters.field##_max_us, stats_start)
+
+static void stats_time(unsigned long &total, unsigned long &longest, unsigned long start) {
+    unsigned long us = micros() - start;
+    total += us;
+    if (us > longest) longest = us;
+    }
+#else
+#define TLC5926_COUNT(field, n)
+#define TLC5926_TIME_START()
+#define TLC5926_TIME(field)
+#endif
+
+TLC5926Stats TLC5926::stats() {
+    noInterrupts(); // async_step() counts too
+    TLC5926Stats now = counters;
+    interrupts();
+    return now;
+    }
+
+TLC5926* TLC5926::reset_stats() {
+    noInterrupts();
+    memset(&counters, 0, sizeof(counters));
+    interrupts();
+    return this;
+    }
+
 TLC5926* TLC5926::debug_prefix() {
         Serial.print("[TLC5926 ");
         Serial.print((uintptr_t)this);
@@ -205,6 +354,42 @@ TLC5926* TLC5926::debug_prefix() {
         return this;
         }
 
+#if TLC5926_TRACE
+struct TLC5926TraceEntry {
+    const void *who;
+    const char *msg;
+    unsigned int value;
+    };
+static TLC5926TraceEntry trace_ring[TLC5926_TRACE];
+static unsigned int trace_ct = 0; // total, so the oldest is at trace_ct % TLC5926_TRACE once wrapped
+
+void TLC5926::trace(const void *who, const char *msg, unsigned int value) {
+    TLC5926TraceEntry *entry = &trace_ring[trace_ct++ % TLC5926_TRACE];
+    entry->who = who;
+    entry->msg = msg;
+    entry->value = value;
+    }
+#endif
+
+#if TLC5926_TRACE
+void TLC5926::dump_trace(Print &out) {
+    // oldest first, then empties the trace
+    unsigned int first = trace_ct > TLC5926_TRACE ? trace_ct - TLC5926_TRACE : 0;
+    for (unsigned int i = first; i < trace_ct; i++) {
+        TLC5926TraceEntry *entry = &trace_ring[i % TLC5926_TRACE];
+        out.print("[TLC5926 ");
+        out.print((uintptr_t)entry->who);
+        out.print("] ");
+        out.print(entry->msg);
+        out.print(" ");
+        out.println(entry->value, HEX);
+        }
+    trace_ct = 0;
+    }
+#else
+void TLC5926::dump_trace(Print &) { }
+#endif
+
 TLC5926* TLC5926::attach(int sdi_pin, int clk_pin) {
     return attach(1, sdi_pin, clk_pin, -1, -1, -1); 
     }
@@ -219,7 +404,7 @@ TLC5926* TLC5926::attach(int sdi_pin, int clk_pin, int le_pin, int ioe_pin) {
 
 TLC5926* TLC5926::attach(int chained_ct, int sdi_pin, int clk_pin, int le_pin, int ioe_pin, int sdo_pin) {
     if (ct) {
-        if (debugging) debug_print("Warning, already attached.");
+        TLC5926_WARN("Warning, already attached.");
         }
 
     else {
@@ -230,11 +415,16 @@ TLC5926* TLC5926::attach(int chained_ct, int sdi_pin, int clk_pin, int le_pin, i
         LE = le_pin;
         iOE = ioe_pin;
         SDO = sdo_pin;
+        sdi_io.bind(SDI);
+        clk_io.bind(CLK);
+        le_io.bind(LE);
+        ioe_io.bind(iOE);
+        sdo_io.bind(SDO);
 
         pinMode(CLK, OUTPUT);
         digitalWrite(CLK, LOW);
         pinMode(SDI, OUTPUT);
-        if (debugging) {
+        if (TLC5926_LOG_LEVEL >= 2 && debugging) {
             debug_prefix();
             Serial.print("Attached to ");
             Serial.print(ct);
@@ -245,7 +435,7 @@ TLC5926* TLC5926::attach(int chained_ct, int sdi_pin, int clk_pin, int le_pin, i
             }
 
         if (LE > -1) {
-            if (debugging) {
+            if (TLC5926_LOG_LEVEL >= 2 && debugging) {
                 Serial.print(", w/LE #");
                 Serial.print(LE);
                 }
@@ -254,7 +444,7 @@ TLC5926* TLC5926::attach(int chained_ct, int sdi_pin, int clk_pin, int le_pin, i
             }
         if (iOE > -1) 
             {
-            if (debugging) {
+            if (TLC5926_LOG_LEVEL >= 2 && debugging) {
                 Serial.print(", w/iOE #");
                 Serial.print(iOE);
                 }
@@ -265,110 +455,281 @@ TLC5926* TLC5926::attach(int chained_ct, int sdi_pin, int clk_pin, int le_pin, i
             }
 
         if (SDO > -1) {
-            if (debugging) {
+            if (TLC5926_LOG_LEVEL >= 2 && debugging) {
                 Serial.print(", w/SDO #");
                 Serial.print(SDO);
                 }
             pinMode(SDO, INPUT); // don't sink
             }
 
-        if (debugging) Serial.println();
+        if (TLC5926_LOG_LEVEL >= 2 && debugging) Serial.println();
+        }
+
+    return this;
+    }
+
+const TLC5926Bus *TLC5926::spi_bus = NULL;
+
+void TLC5926::spi_transport(const TLC5926Bus *bus) { spi_bus = bus; }
+
+TLC5926* TLC5926::attach_spi(int chained_ct, int le_pin, int ioe_pin, int sdo_pin, unsigned long clock) {
+    if (ct) {
+        TLC5926_WARN("Warning, already attached.");
+        return this;
+        }
+
+    attach(chained_ct, MOSI, SCK, le_pin, ioe_pin, sdo_pin);
+    if (!spi_bus) {
+        // same pins, just slower
+        TLC5926_WARN("Warning, attach_spi() needs #include <TLC5926SPI.h>, bit-banging MOSI/SCK");
+        return this;
+        }
+    spi = true;
+    spi_clock = clock;
+    if (TLC5926_LOG_LEVEL >= 2 && debugging) {
+        debug_prefix();
+        Serial.print("SPI at ");
+        Serial.println(spi_clock);
+        }
+    spi_on();
+    return this;
+    }
+
+void TLC5926::spi_on() {
+    // hand MOSI/SCK to the SPI peripheral
+    if (spi && !spi_live) {
+        spi_bus->begin();
+        spi_live = true;
+        }
+    }
+
+void TLC5926::spi_off() {
+    // take MOSI/SCK back for digitalWrite (mode-switch, send_bits, etc)
+    if (spi_live) {
+        spi_bus->end();
+        spi_live = false;
+        clk_io.low();
+        }
+    }
+
+void TLC5926::begin_shift() {
+    async_wait();
+    fb_dirty = true;
+    shifted_all_on = false;
+    if (spi) {
+        spi_on();
+        spi_bus->begin_transaction(spi_clock);
+        }
+    }
+
+void TLC5926::shift_byte(byte b) {
+    TLC5926_COUNT(bytes, 1);
+    TLC5926_COUNT(clocks, 8);
+    if (spi) {
+        byte out = spi_bus->transfer(b); // SDO on MISO
+        if (verifying) verify_byte(out, b);
+        }
+    else if (verifying) {
+        byte out = 0;
+        for (byte mask = 0x80; mask; mask >>= 1) {
+            sdi_io.write(b & mask);
+            out = (out << 1) | sdo_io.read(); // before the clock, like read_sdo()
+            clk_io.pulse();
+            }
+        verify_byte(out, b);
+        }
+    else clock_out(sdi_io, clk_io, b, 8);
+    }
+
+void TLC5926::verify_byte(byte out, byte in) {
+    // the chain is a fifo of bytes: what comes out is what went in, a chain ago
+    int n = frame_bytes();
+    if (verify_ct == n) {
+        for (byte wrong = out ^ verify_ring[verify_head]; wrong; wrong &= wrong - 1) {
+            verify_frame_errors++;
+            verify_errors++;
+            }
+        verify_compared = true;
         }
+    else verify_ct++;
+    verify_ring[verify_head] = in;
+    verify_head = verify_head + 1 == n ? 0 : verify_head + 1;
+    }
 
+void TLC5926::verify_latched() {
+    if (!verifying) return;
+    verify_ok = verify_compared && !verify_frame_errors;
+    verify_compared = false;
+    verify_frame_errors = 0;
+    }
+
+TLC5926* TLC5926::verify(boolean on) {
+    verifying = false;
+    if (on) {
+        if (SDO == -1 || (spi && SDO != MISO)) {
+            TLC5926_WARN("Warning, verify() needs SDO (on MISO for SPI)");
+            return this;
+            }
+        if (!verify_ring) verify_ring = (byte*) malloc(frame_bytes());
+        if (!verify_ring) {
+            TLC5926_WARN("Warning, no memory for verify()");
+            return this;
+            }
+        async_wait();
+        pinMode(SDO, INPUT);
+        verify_head = verify_ct = 0;
+        verify_compared = verify_ok = false;
+        verify_frame_errors = 0;
+        verify_errors = 0;
+        verifying = true;
+        }
     return this;
     }
 
+boolean TLC5926::verified() { return verify_ok; }
+
+unsigned long TLC5926::bit_errors() {
+    noInterrupts(); // async_step() counts too
+    unsigned long errors = verify_errors;
+    interrupts();
+    return errors;
+    }
+
+void TLC5926::end_shift() {
+    if (spi) spi_bus->end_transaction();
+    }
+
 TLC5926* TLC5926::reset() {
     // Try safest sequence to sane config:
     // We should be config(default), normal_mode, etc
 
     if (pwm) pinMode(iOE,OUTPUT); // pwm inhibits digitalWritey
 
+    boolean was_replaying = replaying;
+    replaying = true; // not deferred, even if defer()'d
+
     if (iOE != -1 && LE != -1) normal_mode();
     if (iOE != -1) off();
     if (SDO != -1) pinMode(SDO, INPUT); // so it doesn't affect the chained sdo
     all(LOW); // this could take some time...
+    configs_known = false; // really do it
     if (iOE != -1 && LE != -1) config(1,1,127);
     if (iOE != -1) on();
+
+    replaying = was_replaying;
     return this;
     }
 
-const int NORMAL_MODE_PATTERN[5][3] = {
+// Each step is one byte: TLC5926_STEP(clk, ioe, le)
+const byte NORMAL_MODE_PATTERN[] PROGMEM = {
     // CLK -+
     // OE  ++ less than 2mus on clock
     // LE  --     
-    { LOW , HIGH, LOW }, { HIGH, HIGH, LOW }, // LE low here == normal
-    { LOW , HIGH , LOW  }, { HIGH, HIGH , LOW }, // final "fill"
-    { -1,-1,-1 }
+    TLC5926_STEP(LOW , HIGH, LOW), TLC5926_STEP(HIGH, HIGH, LOW), // LE low here == normal
+    TLC5926_STEP(LOW , HIGH, LOW), TLC5926_STEP(HIGH, HIGH, LOW), // final "fill"
+    TLC5926_STEP_END
     };
-const int SWITCH_MODE_PATTERN[10][3] = {
+const byte SWITCH_MODE_PATTERN[] PROGMEM = {
     // CLK -+-+...
     // OE  ++--++++ less than 2mus on clock
     // LE  ------++     
-    { LOW , HIGH, LOW }, { HIGH, HIGH, LOW }, // start OE hi
-    { LOW , LOW , LOW }, { HIGH, LOW , LOW }, // oe pulse
-    { LOW , HIGH, LOW }, { HIGH, HIGH, LOW },
-    { -1,-1,-1 }
+    TLC5926_STEP(LOW , HIGH, LOW), TLC5926_STEP(HIGH, HIGH, LOW), // start OE hi
+    TLC5926_STEP(LOW , LOW , LOW), TLC5926_STEP(HIGH, LOW , LOW), // oe pulse
+    TLC5926_STEP(LOW , HIGH, LOW), TLC5926_STEP(HIGH, HIGH, LOW),
+    TLC5926_STEP_END
     };
-const int ERROR_DETECT_MODE_PATTERN[9][3] = {
+const byte ERROR_DETECT_MODE_PATTERN[] PROGMEM = {
     // CLK -+ -+ -+ -+ -+ -+ -+ -+ -+ -+
     // iOE ++ -- -- -- wait 2mus, the ++ and clk out 16 bits
     // LE  -- -- -- -- ...
     //NB: causes outputs to sink current!
-    { LOW , HIGH, HIGH }, { HIGH, HIGH, HIGH }, // le pulse = "special mode"
-    { LOW , HIGH , LOW  }, { HIGH, HIGH , LOW }, // final special mode pattern -- "fill"
-    { LOW , LOW , LOW }, { HIGH, LOW , LOW }, // 1 of 3 iOE low
-    { LOW , LOW , LOW }, { HIGH, LOW , LOW }, // 2 of 3 iOE low
+    TLC5926_STEP(LOW , HIGH, HIGH), TLC5926_STEP(HIGH, HIGH, HIGH), // le pulse = "special mode"
+    TLC5926_STEP(LOW , HIGH, LOW ), TLC5926_STEP(HIGH, HIGH, LOW ), // final special mode pattern -- "fill"
+    TLC5926_STEP(LOW , LOW , LOW ), TLC5926_STEP(HIGH, LOW , LOW ), // 1 of 3 iOE low
+    TLC5926_STEP(LOW , LOW , LOW ), TLC5926_STEP(HIGH, LOW , LOW ), // 2 of 3 iOE low
     // wait 2mus from first OE low, then ERROR_DETECT_READY
-    { -1, -1, -1 }
+    TLC5926_STEP_END
     };
-const int ERROR_DETECT_READY[4][3] = { 
-    { LOW , LOW , LOW }, { HIGH, LOW , LOW }, // 3 of 3 iOE low
+const byte ERROR_DETECT_READY[] PROGMEM = { 
+    TLC5926_STEP(LOW , LOW , LOW), TLC5926_STEP(HIGH, LOW , LOW), // 3 of 3 iOE low
     // CLK will shift data like normal while iOE is high
-    { LOW, HIGH, LOW }, // iOE back high, note no clock
-    { -1, -1, -1 }
+    TLC5926_STEP(LOW, HIGH, LOW), // iOE back high, note no clock
+    TLC5926_STEP_END
     };
-const int CONFIGURATION_MODE_PATTERN[5][3] = {
-    { LOW , HIGH , HIGH }, { HIGH, HIGH , HIGH }, // LE = "special mode"
-    { LOW , HIGH , LOW  }, { HIGH, HIGH , LOW }, // final special mode pattern -- "fill"
-    { -1, -1, -1 } // nothing
+const byte ERROR_DETECT_AGAIN[] PROGMEM = {
+    // already in error-detect mode: iOE low again, wait 2mus, then ERROR_DETECT_READY reads it again
+    TLC5926_STEP(LOW , LOW , LOW ), TLC5926_STEP(HIGH, LOW , LOW ), // 1 of 3 iOE low
+    TLC5926_STEP(LOW , LOW , LOW ), TLC5926_STEP(HIGH, LOW , LOW ), // 2 of 3 iOE low
+    TLC5926_STEP_END
+    };
+const byte CONFIGURATION_MODE_PATTERN[] PROGMEM = {
+    TLC5926_STEP(LOW , HIGH, HIGH), TLC5926_STEP(HIGH, HIGH, HIGH), // LE = "special mode"
+    TLC5926_STEP(LOW , HIGH, LOW ), TLC5926_STEP(HIGH, HIGH, LOW ), // final special mode pattern -- "fill"
+    TLC5926_STEP_END // nothing
     };
 
-#define d_digitalWrite(p, v) (Serial.print("Set "), Serial.print(p), Serial.print("="),Serial.println(v), digitalWrite(p,v))
-
-void TLC5926::do_clk_ioe_le(const int state_list[][3]) {
+void TLC5926::play_steps(const byte *steps, TLC5926Pin &clk, TLC5926Pin &ioe, TLC5926Pin &le) {
     // output patterns for the mode stuff: clk+iOE+LE
-    const int *pins;
+    byte step;
+
+#if TLC5926_PORT_IO
+    if (clk.out == ioe.out && clk.out == le.out) {
+        // all on one port: each step is one write
+        uint8_t mask = clk.mask | ioe.mask | le.mask;
+        while ((step = pgm_read_byte(steps++)) != TLC5926_STEP_END) {
+            uint8_t v = (step & 1 ? clk.mask : 0) | (step & 2 ? ioe.mask : 0) | (step & 4 ? le.mask : 0);
+            uint8_t sreg = SREG;
+            cli();
+            *clk.out = (*clk.out & ~mask) | v;
+            SREG = sreg;
+            }
+        clk.low();
+        return;
+        }
+#endif
 
-    for(int i=0; state_list[i][0] != -1; i++) {
-        // debug_prefix(); Serial.print("state line"); Serial.println(i);
-        pins = state_list[i];
-        // Serial.print("COL ");Serial.print(pins[0]); Serial.print(pins[1]);Serial.println(pins[2]);
-        digitalWrite(CLK, pins[0]);
-        digitalWrite(iOE, pins[1]);
-        digitalWrite(LE, pins[2]);
+    while ((step = pgm_read_byte(steps++)) != TLC5926_STEP_END) {
+        clk.write(step & 1);
+        ioe.write(step & 2);
+        le.write(step & 4);
         }
-    digitalWrite(CLK, LOW);
+    clk.low();
     }
 
-void TLC5926::switch_mode(const int pattern[][3]) {
-    if (debugging) debug_print("Switch mode...");
+void TLC5926::do_clk_ioe_le(const byte *steps) {
+    async_wait();
+    spi_off();
+    fb_dirty = true; // mode switches clock junk in
+    shifted_all_on = false;
+    verify_ct = 0;
+#if TLC5926_STATS
+    for (const byte *at = steps; pgm_read_byte(at) != TLC5926_STEP_END; at++) {
+        if (pgm_read_byte(at) & 1) counters.clocks++;
+        }
+#endif
+    play_steps(steps, clk_io, ioe_io, le_io);
+    }
 
-    if (pwm) pinMode(iOE,OUTPUT); // pwm inhibits digitalWrite
+void TLC5926::switch_mode(const byte *pattern, const char *name) {
+    TLC5926_INFO("Switch mode...");
+    TLC5926_COUNT(mode_switches, 1);
+
+    if (pwm) {
+        pinMode(iOE,OUTPUT); // pwm inhibits digitalWrite
+        digitalWrite(iOE, HIGH); // and digitalWrite stops the pwm, so the port writes stick
+        }
 
     do_clk_ioe_le(SWITCH_MODE_PATTERN);
-    if (debugging) debug_print( 
-        pattern == NORMAL_MODE_PATTERN 
-            ? "Normal Mode" 
-            : (pattern == ERROR_DETECT_MODE_PATTERN
-            ? "Error Detect Mode"
-            : (pattern == CONFIGURATION_MODE_PATTERN
-            ? "Config Mode"
-            : "undef mode"))
-        );
+    TLC5926_INFO(name);
     do_clk_ioe_le(pattern);
     }
 
+void TLC5926::restore_ioe() {
+    // the mode patterns end with iOE high (off), so back to what on()/off()/brightness() had
+    if (ioe_level == 255) on();
+    else if (ioe_level && pwm) brightness(ioe_level);
+    }
+
 TLC5926* TLC5926::normal_mode() {
         /*
         Back to normal mode:
@@ -377,17 +738,17 @@ TLC5926* TLC5926::normal_mode() {
             LE  ------ ----     
         */
     if (LE == -1 || iOE == -1) {
-        if (debugging) debug_print("Can't do normal_mode() w/o LE and iOE");
+        TLC5926_WARN("Can't do normal_mode() w/o LE and iOE");
         }
     else {
-        switch_mode(NORMAL_MODE_PATTERN);
+        switch_mode(NORMAL_MODE_PATTERN, "Normal Mode");
         }
     return this;
     }
 
 unsigned short int TLC5926::read_sdo() {
     if (SDO == -1) {
-        if (debugging) debug_print("Can't do read_sdo() w/o SDO");
+        TLC5926_WARN("Can't do read_sdo() w/o SDO");
         return 0;
         }
     else {
@@ -396,152 +757,337 @@ unsigned short int TLC5926::read_sdo() {
         }
     }
 
-unsigned int TLC5926::error_detect() {
-    // Returns 16 bits
-    unsigned int status = 0;
-
+boolean TLC5926::error_detect_begin() {
+    // Everybody on, into error-detect mode, and ready to clock the status out of SDO
     if (LE == -1 || iOE == -1 || SDO == -1) {
-        if (debugging) debug_print("Can't do error_detect() w/o LE, iOE, and SDO");
+        TLC5926_WARN("Can't do error_detect() w/o LE, iOE, and SDO");
+        return false;
         }
-    else {
-        send(0xFFFF); // everybody on for detect. we can only read the first in a chain
-        // on(); // need it on to work
-        switch_mode(ERROR_DETECT_MODE_PATTERN);
-        ::delayMicroseconds(3); // actually, from earlier in the pattern, but "at least 2"
 
-        if (debugging) debug_print("Read status...");
-        do_clk_ioe_le(ERROR_DETECT_READY); // ready for read
-        if (debugging) debug_print("Ready");
+    detect_was_replaying = replaying;
+    replaying = true; // not deferred, even if defer()'d
 
-        pinMode(SDO, INPUT);
-        digitalWrite(SDI, LOW); // we clock SDO out, and clock SDI in, so leave low
+    if (!latched_all_on) all(HIGH); // everybody on for detect
+    // on(); // need it on to work
+    switch_mode(ERROR_DETECT_MODE_PATTERN, "Error Detect Mode");
+    ::delayMicroseconds(3); // actually, from earlier in the pattern, but "at least 2"
 
-        for(int i=0; i<16; i++) {
-            int r;
-            r = digitalRead(SDO); 
-            Serial.println(r,HEX);
-            status = (status << 1) | r;
-            Serial.print("clock data ");Serial.print(i); Serial.print(" "); Serial.println(status,BIN);
+    TLC5926_INFO("Read status...");
+    do_clk_ioe_le(ERROR_DETECT_READY); // ready for read
+    TLC5926_INFO("Ready");
+
+    pinMode(SDO, INPUT);
+    sdi_io.low(); // we clock SDO out, and clock SDI in, so leave low
+    return true;
+    }
 
-            digitalWrite(CLK,HIGH); // "detect" on rising
-            digitalWrite(CLK,LOW);
+unsigned int TLC5926::error_status_word(byte bits, boolean log) {
+    // a chip's bits (16, or 8) from SDO, i.e. the last chip in the chain, then the next, etc.
+    unsigned int status = 0;
 
+    TLC5926_COUNT(clocks, bits);
+    for(int i=0; i<bits; i++) {
+        int r;
+        r = sdo_io.read(); 
+        status = (status << 1) | r;
+        if (TLC5926_LOG_LEVEL >= 3 && debugging && log) {
+            debug_prefix();
+            Serial.print("clock data ");Serial.print(i); Serial.print(" "); Serial.println(status,BIN);
             }
-        Serial.println("clocked!");
+
+        clk_io.pulse(); // "detect" on rising
+
+        }
+    if (TLC5926_LOG_LEVEL >= 2 && log) {
+        trace(this, "Error Detect Status", status);
         if (debugging) {
             debug_prefix();
             Serial.print("Error Detect Status ");
             Serial.println(status,BIN);
             }
+        }
+    return status;
+    }
 
-        pinMode(SDO, OUTPUT);
-        normal_mode();
+void TLC5926::error_detect_end() {
+    pinMode(SDO, verifying ? INPUT : OUTPUT);
+    normal_mode();
+    restore_ioe();
+    replaying = detect_was_replaying;
+    }
+
+unsigned int TLC5926::error_detect() {
+    // Returns 16 bits (or 8), for the last chip in the chain (the one on SDO)
+    unsigned int status = 0;
+
+    TLC5926_TIME_START();
+    if (error_detect_begin()) {
+        status = error_status_word(chip_width(ct - 1));
+        error_detect_end();
+        TLC5926_TIME(error_detect);
         }
     return status;
     }
 
+int TLC5926::error_detect(unsigned int *status, int chip_ct) {
+    // The whole chain in one pass: status[i] is chip i. Returns how many chips.
+    if (chip_ct < ct) {
+        TLC5926_WARN("Warning, error_detect() needs room for every chip");
+        return 0;
+        }
+    TLC5926_TIME_START();
+    if (!error_detect_begin()) return 0;
+
+    for (int i = ct - 1; i >= 0; i--) status[i] = error_status_word(chip_width(i)); // last chip comes out first
+    error_detect_end();
+    TLC5926_TIME(error_detect);
+    return ct;
+    }
+
+int TLC5926::error_detect(TLC5926Diag *diag, int chip_ct) {
+    if (chip_ct < ct) {
+        TLC5926_WARN("Warning, error_detect() needs room for every chip");
+        return 0;
+        }
+    TLC5926_TIME_START();
+    if (!error_detect_begin()) return 0;
+
+    for (int i = ct - 1; i >= 0; i--) {
+        // every channel was on, so a 0 is a failed channel
+        unsigned int all_bits = chip_width(i) == 16 ? 0xFFFF : 0xFF;
+        diag[i].status = error_status_word(chip_width(i));
+        diag[i].faults = ~diag[i].status & all_bits;
+        diag[i].over_temp = diag[i].faults == all_bits;
+        }
+    error_detect_end();
+    TLC5926_TIME(error_detect);
+    return ct;
+    }
+
+boolean TLC5926::detect_hold() {
+    if (detect_held) return true;
+    detect_held = error_detect_begin();
+    return detect_held;
+    }
+
+int TLC5926::detect_sample(unsigned int *status, int chip_ct) {
+    // still in error-detect mode, so just the iOE-low/read part of error_detect()
+    if (!detect_held || chip_ct < ct) return 0;
+    async_wait();
+    return isr_detect(status, chip_ct);
+    }
+
+int TLC5926::isr_detect(unsigned int *status, int chip_ct) {
+    // detect_hold() already took the pins back from SPI, so just the steps
+    if (!detect_held || chip_ct < ct) return 0;
+    play_steps(ERROR_DETECT_AGAIN, clk_io, ioe_io, le_io);
+    ::delayMicroseconds(2); // plus the steps, "at least 2"
+    play_steps(ERROR_DETECT_READY, clk_io, ioe_io, le_io);
+    TLC5926_COUNT(clocks, 3); // the steps'
+    for (int i = ct - 1; i >= 0; i--) status[i] = error_status_word(chip_width(i), false);
+    return ct;
+    }
+
+TLC5926* TLC5926::detect_release() {
+    if (detect_held) {
+        detect_held = false;
+        error_detect_end();
+        }
+    return this;
+    }
+
+byte TLC5926::config_value(int hi_lo_current, int hi_lo_voltage_band, int voltage_gain) {
+    // We are going to do LSB shift, so voltage_gain reads: large=high
+    byte value;
+    value = voltage_gain & 0x003F ; // 0-127
+    if (hi_lo_current) value |= 0x80;
+    if (hi_lo_voltage_band) value |= 0x40;
+    return value;
+    }
+
 TLC5926* TLC5926::config(int hi_lo_current, int hi_lo_voltage_band, int voltage_gain) {
+    // every chip gets the same
+    return config_chain(NULL, config_value(hi_lo_current, hi_lo_voltage_band, voltage_gain));
+    }
+
+TLC5926* TLC5926::config(const byte *values, int chip_ct) {
+    // values[i] (from config_value()) for chip i
+    if (chip_ct < ct) {
+        TLC5926_WARN("Warning, config() needs a value for every chip");
+        return this;
+        }
+    return config_chain(values, 0);
+    }
+
+TLC5926* TLC5926::config_chain(const byte *values, byte value) {
+    // values[i] for chip i, or value for all of them if values is NULL
     if (LE == -1 || iOE == -1) {
-        if (debugging) debug_print("Can't do config() w/o LE, iOE");
+        TLC5926_WARN("Can't do config() w/o LE, iOE");
+        return this;
+        }
+
+    if (!configs) configs = (byte*) malloc(ct);
+    if (configs && configs_known) {
+        // nothing to do if every chip already has it
+        int i;
+        for (i = 0; i < ct && configs[i] == (values ? values[i] : value); i++) ;
+        if (i == ct) return this;
         }
-    else {
-        send(0xFFFF); // everybody on for detect. we can only read the first in a chain
-        switch_mode(CONFIGURATION_MODE_PATTERN);
 
-        // We are going to do LSB shift, so voltage_gain reads: large=high
-        unsigned int value;
-        value = voltage_gain & 0x003F ; // 0-127
-        if (hi_lo_current) value |= 0x80;
-        if (hi_lo_voltage_band) value |= 0x40;
-        // Serial.print("Config "); Serial.println(value, BIN);
-        shiftOut(SDI, CLK, MSBFIRST, 00); // high-bits are zero
-        shiftOut(SDI, CLK, LSBFIRST, value); // CM.HC.CC6
-        latch_pulse();
-        normal_mode();
+    TLC5926_TIME_START();
+    boolean was_replaying = replaying;
+    replaying = true; // not deferred, even if defer()'d
+
+    // The outputs keep their pattern: config mode latches into the config register, not the outputs
+    switch_mode(CONFIGURATION_MODE_PATTERN, "Config Mode");
+
+    fb_dirty = true;
+    shifted_all_on = false;
+    for (int chip = ct - 1; chip >= 0; chip--) {
+        // last chip first
+        byte v = values ? values[chip] : value;
+        // Serial.print("Config "); Serial.println(v, BIN);
+        sdi_io.low(); // high-bits are zero. An 8 bit chip's config register is just the 8
+        if (chip_width(chip) == 16) for (int i = 0; i < 8; i++) clk_io.pulse();
+        TLC5926_COUNT(clocks, chip_width(chip));
+        for (byte mask = 0x01; mask; mask <<= 1) { // LSB first: CM.HC.CC6
+            sdi_io.write(v & mask);
+            clk_io.pulse();
+            }
+        if (configs) configs[chip] = v;
         }
+    le_io.pulse(); // into the config register
+    configs_known = configs != NULL;
+    normal_mode();
+    restore_ioe();
+    replaying = was_replaying;
+    TLC5926_TIME(config);
 
     return this;
     }
 
 TLC5926* TLC5926::latch_pulse() {
+    if (defer_step(STEP_LATCH, 0)) return this;
     if (LE != -1) {
-        digitalWrite(LE, HIGH); // we were low, this is "doit"
-        digitalWrite(LE, LOW); // for next time
+        async_wait();
+        le_io.pulse(); // we were low, high is "doit", low for next time
+        TLC5926_COUNT(latches, 1);
+        verify_latched();
+        latched_all_on = shifted_all_on;
         }
     else {
-        if (debugging) debug_print("Warning: latch_pulse() -- LE not specified");
+        TLC5926_WARN("Warning: latch_pulse() -- LE not specified");
         }
     return this;
     }
 
 TLC5926* TLC5926::on() {
+    if (defer_step(STEP_ON, 0)) return this;
     if (iOE != -1) {
-        if (debugging) debug_print("ON");
+        TLC5926_INFO("ON");
+        ioe_level = 255;
         if (pwm) pinMode(iOE,OUTPUT); // pwm inhibits digitalWriteyy
         digitalWrite(iOE, LOW); // inverted
         }
     else {
-        if (debugging) debug_print("Warning: on() -- iOE not specified");
+        TLC5926_WARN("Warning: on() -- iOE not specified");
         }
     return this;
     }
 
 TLC5926* TLC5926::off() {
+    if (defer_step(STEP_OFF, 0)) return this;
     if (iOE != -1) {
-        if (debugging) debug_print("OFF");
+        TLC5926_INFO("OFF");
+        ioe_level = 0;
         if (pwm) pinMode(iOE,OUTPUT); // pwm inhibits digitalWriteyy
         digitalWrite(iOE, HIGH); // inverted
         }
     else {
-        if (debugging) debug_print("Warning: off() -- iOE not specified");
+        TLC5926_WARN("Warning: off() -- iOE not specified");
         }
     return this;
     }
 
 TLC5926* TLC5926::send(unsigned int pattern) {
+    if (defer_step(STEP_SEND, pattern)) return this;
+    TLC5926_TIME_START();
     shift(pattern);
     if (LE != -1) latch_pulse();
+    TLC5926_TIME(send);
     return this;
     }
 
 void TLC5926::shift(unsigned int pattern) {
-    shiftOut(SDI, CLK, MSBFIRST, pattern >> 8); // msb
-    shiftOut(SDI, CLK, MSBFIRST, lowByte(pattern)); // msb
+    if (remap) pattern = to_physical(pattern, -1);
+    begin_shift();
+    shift_byte(pattern >> 8); // msb
+    shift_byte(lowByte(pattern)); // msb
+    end_shift();
     }
 
 TLC5926* TLC5926::all(int hilo) {
-    for (int i=0; i<ct; i++) {
-        shift(hilo ? 0xFFFF : 0);
-        }
+    if (defer_step(STEP_ALL, hilo)) return this;
+    TLC5926_TIME_START();
+    // one transaction for the whole chain
+    begin_shift();
+    for (int i = frame_bytes(); i > 0; i--) shift_byte(hilo ? 0xFF : 0);
+    end_shift();
+    shifted_all_on = hilo;
     if (LE != -1) latch_pulse();
+    TLC5926_TIME(all);
     return this;
     }
 
 TLC5926* TLC5926::send_bits(int ct, short int bits, int delay_between) { 
-    for (; ct>0; ct--) {
-        digitalWrite(SDI, bitRead(bits, ct-1));
-        digitalWrite(CLK, HIGH);
-        digitalWrite(CLK, LOW);
-        if (delay_between) {
-            if (LE != -1) latch_pulse();
-            ::delay(delay_between) ;
+    if (queue && !replaying) {
+        // a bit at a time, so the delays between are deferred too
+        for (; ct>0; ct--) {
+            if (delay_between) {
+                defer_step(STEP_SEND_BITS, (1UL << 16) | bitRead(bits, ct-1));
+                delay(delay_between);
+                }
+            else {
+                defer_step(STEP_SEND_BITS, ((unsigned long)ct << 16) | (unsigned short) bits);
+                break;
+                }
             }
+        return this;
+        }
+    async_wait();
+    spi_off();
+    fb_dirty = true;
+    shifted_all_on = false;
+    verify_ct = 0; // not bytes
+    TLC5926_COUNT(clocks, ct);
+    if (!delay_between) {
+        if (ct > 0) clock_out(sdi_io, clk_io, (unsigned short) bits, ct);
+        if (LE != -1) latch_pulse();
+        return this;
+        }
+    for (; ct>0; ct--) {
+        // a bit, a latch, a pause
+        sdi_io.write(bitRead(bits, ct-1));
+        clk_io.pulse();
+        if (LE != -1) latch_pulse();
+        ::delay(delay_between) ;
         }
-    if (!delay_between && LE != -1) latch_pulse();
     return this;
     } 
 
 TLC5926* TLC5926::brightness(char brightness) {
     // 255 levels of brightness should be enough for anyone?
+    if (defer_step(STEP_BRIGHTNESS, (byte) brightness)) return this;
     if (iOE == -1) {
-        if (debugging) debug_print("Warning, no way to do brightness if not using iOE");
+        TLC5926_WARN("Warning, no way to do brightness if not using iOE");
         return this; // we could do blocking brightness
         }
     else if (!pwm) {
-        if (debugging) debug_print("Warning, iOE pin is not on a PWM");
+        TLC5926_WARN("Warning, iOE pin is not on a PWM");
         // we could do blocking brightness
         }
     else {
+        ioe_level = brightness;
         analogWrite(iOE, ~(brightness));
         }
     return this;
@@ -549,12 +1095,14 @@ TLC5926* TLC5926::brightness(char brightness) {
 
 TLC5926* TLC5926::delay(unsigned long duration) {
     // just for convenience of chaining
+    if (defer_step(STEP_DELAY, duration)) return this;
     ::delay(duration);
     return this;
     }
 
 TLC5926* TLC5926::delayMicroseconds(unsigned int duration) {
     // just for convenience of chaining
+    if (defer_step(STEP_DELAY_US, duration)) return this;
     ::delayMicroseconds(duration);
     return this;
     }
@@ -565,12 +1113,478 @@ TLC5926* TLC5926::flash(unsigned int on_duration, unsigned int bracket, boolean
     // thus, you don't need to delay() on either side.
     // ... for non iOE mode, could starttime, shift in 1's, latch, hold for brackettimeleft, 0's, latch, hold
     //          but that might be confusing because in that mode it whacks the pattern?
+    // (our delay(), so it is queued if defer()'d)
     off();
-    ::delay(bracket);
+    delay(bracket);
     on();
-    ::delay(on_duration);
+    delay(on_duration);
     off();
-    ::delay(bracket);
+    delay(bracket);
     if (leave_on) on();
     return this;
     }
+
+int TLC5926::channels() { return widths ? width_total : ct * 16; }
+
+int TLC5926::frame_bytes() { return channels() / 8; }
+
+boolean TLC5926::has_8bit_chip() { return widths && width_total != ct * 16; }
+
+TLC5926* TLC5926::chip_widths(const byte *bits, int chip_ct) {
+    if (chip_ct < ct) {
+        TLC5926_WARN("Warning, chip_widths() needs a width for every chip");
+        return this;
+        }
+    int total = 0;
+    for (int i = 0; i < ct; i++) {
+        if (bits[i] != 8 && bits[i] != 16) {
+            TLC5926_WARN("Warning, chip_widths() are 8 or 16");
+            return this;
+            }
+        total += bits[i];
+        }
+
+    async_wait();
+    if (!widths) widths = (byte*) malloc(ct);
+    if (!widths) {
+        TLC5926_WARN("Warning, no memory for chip_widths()");
+        return this;
+        }
+    memcpy(widths, bits, ct);
+    width_total = total;
+    // a channel_map() from before has to keep an 8 bit chip's channels in its 8 outputs
+    if (remap && has_8bit_chip() && (remap[15] | remap[16 + 15]) != 0x00FF) {
+        TLC5926_WARN("Warning, channel_map() for a TLC5916: map[0..7] has to be 0..7, dropped it");
+        channel_map(NULL);
+        }
+
+    // different size now
+    free(fb);
+    free(shadow);
+    free(verify_ring);
+    fb = shadow = verify_ring = NULL;
+    verifying = false;
+    fb_dirty = true;
+    return this;
+    }
+
+TLC5926* TLC5926::channel_map(const byte *map, const boolean *mirror, int chip_ct) {
+    async_wait();
+    free(remap);
+    free(mirrored);
+    remap = NULL;
+    mirrored = NULL;
+    fb_dirty = true; // the chain has the old order
+    if (!map && !mirror) return this;
+
+    if (mirror && chip_ct < ct) {
+        TLC5926_WARN("Warning, channel_map() needs mirrored[] for every chip");
+        return this;
+        }
+    unsigned int outs = 0;
+    for (int i = 0; map && i < 16; i++) {
+        if (map[i] > 15) {
+            TLC5926_WARN("Warning, channel_map() outputs are 0..15");
+            return this;
+            }
+        outs |= 1 << map[i];
+        }
+    if (map && outs != 0xFFFF) {
+        TLC5926_WARN("Warning, channel_map() has to use each output once");
+        return this;
+        }
+    for (int i = 0; map && i < 8; i++) {
+        if (map[i] > 7 && has_8bit_chip()) {
+            TLC5926_WARN("Warning, channel_map() for a TLC5916: map[0..7] has to be 0..7");
+            return this;
+            }
+        }
+    boolean any_mirrored = false;
+    for (int i = 0; mirror && i < ct; i++) any_mirrored |= mirror[i];
+
+    remap = (unsigned int*) malloc((any_mirrored ? 128 : 64) * sizeof(unsigned int));
+    if (any_mirrored) mirrored = (byte*) malloc(ct);
+    if (!remap || (any_mirrored && !mirrored)) {
+        TLC5926_WARN("Warning, no memory for channel_map()");
+        free(remap);
+        remap = NULL;
+        return this;
+        }
+    if (mirrored) for (int i = 0; i < ct; i++) mirrored[i] = mirror[i];
+
+    // remap[n * 16 + v]: where the bits v of the word's nibble n end up. Then the same, mirrored (OUT0<->OUT15)
+    for (int n = 0; n < 4; n++) {
+        for (int v = 0; v < 16; v++) {
+            unsigned int bits = 0, reversed = 0;
+            for (int b = 0; b < 4; b++) {
+                if (!(v & (1 << b))) continue;
+                int out = map ? map[n * 4 + b] : n * 4 + b;
+                bits |= 1 << out;
+                reversed |= 0x8000 >> out;
+                }
+            remap[n * 16 + v] = bits;
+            if (any_mirrored) remap[64 + n * 16 + v] = reversed;
+            }
+        }
+    return this;
+    }
+
+unsigned int TLC5926::to_physical(unsigned int word, int chip) {
+    // 4 lookups, whatever the map
+    boolean mirror = chip >= 0 && mirrored && mirrored[chip];
+    const unsigned int *nibbles = mirror ? remap + 64 : remap;
+    unsigned int physical = nibbles[word & 0xF] | nibbles[16 + ((word >> 4) & 0xF)]
+        | nibbles[32 + ((word >> 8) & 0xF)] | nibbles[48 + ((word >> 12) & 0xF)];
+    // an 8 bit chip mirrored lands in the high byte
+    return mirror && chip_width(chip) == 8 ? physical >> 8 : physical;
+    }
+
+int TLC5926::chips() { return ct; }
+
+int TLC5926::chip_width(int chip) { return widths ? widths[chip] : 16; }
+
+int TLC5926::chip_channel(int chip) {
+    if (!widths) return chip * 16;
+    int channel = 0;
+    for (int i = 0; i < chip; i++) channel += widths[i];
+    return channel;
+    }
+
+byte* TLC5926::frame() {
+    if (!fb && ct) {
+        fb = (byte*) calloc(frame_bytes(), 1);
+        if (!fb) TLC5926_WARN("Warning, no memory for the framebuffer");
+        }
+    return fb;
+    }
+
+TLC5926* TLC5926::set(int channel, int hilo) {
+    if (channel < 0 || channel >= channels() || !frame()) {
+        TLC5926_WARN("Warning, set() channel out of range");
+        return this;
+        }
+    // channel 0 is the last bit shifted
+    byte *at = &fb[frame_bytes() - 1 - (channel >> 3)];
+    byte mask = 1 << (channel & 7);
+    byte was = *at;
+    if (hilo) *at |= mask;
+    else *at &= ~mask;
+    if (*at != was) fb_dirty = true;
+    return this;
+    }
+
+TLC5926* TLC5926::clear(int channel) {
+    return set(channel, LOW);
+    }
+
+TLC5926* TLC5926::toggle(int channel) {
+    return set(channel, !get(channel));
+    }
+
+int TLC5926::get(int channel) {
+    if (channel < 0 || channel >= channels() || !frame()) return LOW;
+    return (fb[frame_bytes() - 1 - (channel >> 3)] >> (channel & 7)) & 1;
+    }
+
+TLC5926* TLC5926::set_word(int chip, unsigned int pattern) {
+    // same bit order as send(pattern) to that chip
+    if (chip < 0 || chip >= ct) {
+        TLC5926_WARN("Warning, set_word() chip out of range");
+        return this;
+        }
+    int byte_ct = chip_width(chip) / 8;
+    int at = frame_bytes() - (chip_channel(chip) / 8) - byte_ct;
+    byte hilo[2] = { highByte(pattern), lowByte(pattern) };
+    return set_bytes(at, hilo + 2 - byte_ct, byte_ct);
+    }
+
+TLC5926* TLC5926::set_bytes(int offset, const byte *bytes, int byte_ct) {
+    // offset is in frame() order
+    if (offset < 0 || offset + byte_ct > frame_bytes() || !frame()) {
+        TLC5926_WARN("Warning, set_bytes() out of range");
+        return this;
+        }
+    if (memcmp(fb + offset, bytes, byte_ct)) {
+        memcpy(fb + offset, bytes, byte_ct);
+        fb_dirty = true;
+        }
+    return this;
+    }
+
+TLC5926* TLC5926::fill(int hilo) {
+    if (!frame()) return this;
+    byte v = hilo ? 0xFF : 0;
+    for (int i = frame_bytes() - 1; i >= 0; i--) {
+        if (fb[i] != v) {
+            fb[i] = v;
+            fb_dirty = true;
+            }
+        }
+    return this;
+    }
+
+boolean TLC5926::dirty() { return fb_dirty; }
+
+void TLC5926::shift_bytes(const byte *bytes, int byte_ct) {
+    begin_shift();
+    shift_run(bytes, byte_ct);
+    end_shift();
+    }
+
+void TLC5926::shift_run(const byte *bytes, int byte_ct) {
+    if (remap && byte_ct == frame_bytes()) {
+        // a whole frame: a chip at a time through the channel map, last chip first
+        for (int chip = ct - 1; chip >= 0; chip--) {
+            if (chip_width(chip) == 16) {
+                unsigned int physical = to_physical((bytes[0] << 8) | bytes[1], chip);
+                shift_byte(physical >> 8);
+                shift_byte(physical);
+                bytes += 2;
+                }
+            else shift_byte(to_physical(*bytes++, chip));
+            }
+        }
+    else {
+        for (int i = 0; i < byte_ct; i++) shift_byte(bytes[i]);
+        }
+    }
+
+TLC5926* TLC5926::isr_ready() {
+    // everything shift_bytes() would do in the isr, done once here
+    async_wait();
+    spi_on();
+    fb_dirty = true;
+    shifted_all_on = latched_all_on = false;
+    return this;
+    }
+
+void TLC5926::isr_shift(const byte *bytes, int byte_ct) {
+    if (spi) spi_bus->begin_transaction(spi_clock);
+    shift_run(bytes, byte_ct);
+    if (spi) spi_bus->end_transaction();
+    }
+
+TLC5926* TLC5926::isr_latch() {
+    if (LE != -1) {
+        le_io.pulse();
+        TLC5926_COUNT(latches, 1);
+        verify_latched();
+        }
+    return this;
+    }
+
+TLC5926* TLC5926::scroll(int ct, short int bits) {
+    if (ct < 1 || ct > 16) {
+        TLC5926_WARN("Warning, scroll() is 1..16 bits");
+        return this;
+        }
+    if (defer_step(STEP_SCROLL, ((unsigned long)ct << 16) | (unsigned short) bits)) return this;
+
+    boolean was_dirty = fb_dirty;
+    if (frame()) {
+        // same as the chain: the whole frame moves left (toward frame()[0]), new bits come in at the end
+        int last = frame_bytes() - 1;
+        for (int left = ct; left > 0; left -= 8) {
+            byte s = left > 8 ? 8 : left;
+            byte in = (bits >> (left - s)) & ((1 << s) - 1);
+            for (int i = 0; i < last; i++) fb[i] = (fb[i] << s) | (fb[i + 1] >> (8 - s));
+            fb[last] = (fb[last] << s) | in;
+            }
+        }
+    send_bits(ct, bits);
+    fb_dirty = was_dirty || remap; // the chain moved physically: with a channel_map(), the next flush() fixes it up
+    return this;
+    }
+
+TLC5926* TLC5926::flush() {
+    // whole chain in one pass, one latch. Nothing to do if it hasn't changed.
+    if (defer_step(STEP_FLUSH, 0)) return this;
+    if (!fb_dirty || !frame()) return this;
+    shift_bytes(fb, frame_bytes());
+    shifted_all_on = true;
+    for (int i = frame_bytes() - 1; i >= 0 && shifted_all_on; i--) shifted_all_on = fb[i] == 0xFF;
+    if (LE != -1) latch_pulse();
+    fb_dirty = false;
+    return this;
+    }
+
+TLC5926* TLC5926::defer(TLC5926Step *steps, byte len) {
+    queue = len ? steps : NULL;
+    queue_len = len;
+    queue_head = queue_ct = 0;
+    waiting = false;
+    return this;
+    }
+
+TLC5926* TLC5926::clock(unsigned long (*millis_fn)(), unsigned long (*micros_fn)()) {
+    now_ms = millis_fn;
+    now_us = micros_fn;
+    return this;
+    }
+
+boolean TLC5926::defer_step(byte op, unsigned long arg) {
+    // true if queued (or dropped), i.e. caller shouldn't do it now
+    if (!queue || replaying) return false;
+
+    if (queue_ct == queue_len) {
+        TLC5926_WARN("Warning, defer() queue full, step dropped");
+        return true;
+        }
+    TLC5926Step *step = &queue[(queue_head + queue_ct) % queue_len];
+    step->op = op;
+    step->arg = arg;
+    queue_ct++;
+    return true;
+    }
+
+boolean TLC5926::busy() { return waiting || queue_ct; }
+
+boolean TLC5926::update() {
+    if (!queue) return false;
+
+    if (waiting) {
+        unsigned long elapsed = (wait_us ? now_us() : now_ms()) - wait_start;
+        if (elapsed < wait_for) return true;
+        waiting = false;
+        }
+
+    replaying = true;
+    while (queue_ct && !waiting) {
+        TLC5926Step step = queue[queue_head];
+        queue_head = (queue_head + 1) % queue_len;
+        queue_ct--;
+
+        switch (step.op) {
+            case STEP_SEND: send(step.arg); break;
+            case STEP_ALL: all(step.arg); break;
+            case STEP_SEND_BITS: send_bits(step.arg >> 16, step.arg & 0xFFFF); break;
+            case STEP_LATCH: latch_pulse(); break;
+            case STEP_ON: on(); break;
+            case STEP_OFF: off(); break;
+            case STEP_BRIGHTNESS: brightness(step.arg); break;
+            case STEP_FLUSH: flush(); break;
+            case STEP_SCROLL: scroll(step.arg >> 16, step.arg & 0xFFFF); break;
+            case STEP_DELAY:
+            case STEP_DELAY_US:
+                wait_us = step.op == STEP_DELAY_US;
+                wait_start = wait_us ? now_us() : now_ms();
+                wait_for = step.arg;
+                waiting = true;
+                break;
+            }
+        }
+    replaying = false;
+
+    return busy();
+    }
+
+TLC5926 *TLC5926::async_running = NULL;
+
+void TLC5926::async_wait() {
+    while (async_busy) async_poll(); // the isr finishes it, or we do
+    }
+
+void TLC5926::async_poll() {
+    // no timer (no TLC5926TimerISR.h, not AVR): the next chunk, from here. Interrupts off, in case
+    // your own timer is calling async_step() too
+    if (!async_busy || async_timed) return;
+    noInterrupts();
+    async_step();
+    interrupts();
+    }
+
+TLC5926* TLC5926::async_rate(unsigned int period_us, byte bytes_per_tick) {
+    async_period_us = period_us;
+    async_chunk = bytes_per_tick ? bytes_per_tick : 1;
+    return this;
+    }
+
+TLC5926* TLC5926::on_async_done(void (*callback)()) {
+    async_done_fn = callback;
+    return this;
+    }
+
+boolean TLC5926::async_done() {
+    async_poll();
+    return !async_busy;
+    }
+
+boolean TLC5926::send_async(const byte *frame) {
+    if (async_busy) return false;
+    // one timer, one async_running: another chain's frame has to finish first
+    if (async_running && async_running != this) return false;
+    if (!shadow && ct) shadow = (byte*) malloc(frame_bytes());
+    if (!shadow) {
+        TLC5926_WARN("Warning, no memory for send_async()");
+        return false;
+        }
+    if (remap) {
+        // physical order now, so the isr just shifts
+        byte *to = shadow;
+        for (int chip = ct - 1; chip >= 0; chip--) {
+            if (chip_width(chip) == 16) {
+                unsigned int physical = to_physical((frame[0] << 8) | frame[1], chip);
+                *to++ = physical >> 8;
+                *to++ = physical;
+                frame += 2;
+                }
+            else *to++ = to_physical(*frame++, chip);
+            }
+        }
+    else memcpy(shadow, frame, frame_bytes());
+    fb_dirty = true;
+    return start_async();
+    }
+
+boolean TLC5926::flush_async() {
+    if (async_busy) return false;
+    if (!fb_dirty || !frame()) return true; // nothing changed
+    if (!send_async(fb)) return false;
+    fb_dirty = false; // will be, when it latches. Changes from now on re-dirty it
+    return true;
+    }
+
+boolean TLC5926::start_async() {
+    async_at = 0;
+    shifted_all_on = false;
+    async_running = this;
+    async_busy = true;
+    async_timed = timer_start && timer_start(async_isr, async_period_us);
+    return true;
+    }
+
+boolean (*TLC5926::timer_start)(void (*isr)(), unsigned int period_us) = NULL;
+void (*TLC5926::timer_stop)() = NULL;
+
+void TLC5926::async_timer(boolean (*start)(void (*isr)(), unsigned int period_us), void (*stop)()) {
+    timer_start = start;
+    timer_stop = stop;
+    }
+
+void TLC5926::async_isr() {
+    if (async_running) async_running->async_step();
+    }
+
+void TLC5926::async_step() {
+    // a few bytes, and latch at the end
+    if (!async_busy) return;
+
+    if (spi) {
+        spi_on();
+        spi_bus->begin_transaction(spi_clock);
+        }
+    for (byte i = 0; i < async_chunk && async_at < frame_bytes(); i++) shift_byte(shadow[async_at++]);
+    if (spi) spi_bus->end_transaction();
+
+    if (async_at == frame_bytes()) {
+        if (LE != -1) le_io.pulse();
+        TLC5926_COUNT(latches, 1);
+        verify_latched();
+        latched_all_on = false;
+        if (async_timed) timer_stop();
+        async_timed = false;
+        async_busy = false;
+        async_running = NULL; // the timer's free
+        if (async_done_fn) async_done_fn();
+        }
+    }
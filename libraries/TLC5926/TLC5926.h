@@ -4,8 +4,148 @@
 // #include <inttypes.h>
 #include <Arduino.h>
 
+// Compile-time log level: 0 none, 1 warnings, 2 info (mode switches, on/off, etc.), 3 per-bit detail.
+// Messages below the level aren't compiled in at all (no Serial I/O, no code).
+// At/above it, they print only if debug(1), and go to the trace (if any).
+// The library is compiled separately from your sketch, so change these here, or with -D build flags.
+#ifndef TLC5926_LOG_LEVEL
+#define TLC5926_LOG_LEVEL 2
+#endif
+
+// Number of entries in a RAM trace of the log messages (shared by all instances), dumped by TLC5926::dump_trace().
+// 0 is no trace. Each entry is 6 bytes on AVR.
+#ifndef TLC5926_TRACE
+#define TLC5926_TRACE 0
+#endif
+
+// 1: count clock edges, latches, bytes shifted, mode switches, and the time spent in send()/all()/config()/
+// error_detect(), per instance, see TLC5926::stats(). 0: the counting isn't compiled in (stats() is all 0's).
+// Like the others, set it here or with a -D build flag: a #define in the sketch doesn't reach the library.
+#ifndef TLC5926_STATS
+#define TLC5926_STATS 0
+#endif
+
+// 1: pins are written straight to their AVR port registers. 0: every edge goes through
+// digitalWrite()/digitalRead(), e.g. so a host-side stand-in for the Arduino core sees every edge.
+#ifndef TLC5926_PORT_IO
+#ifdef __AVR__
+#define TLC5926_PORT_IO 1
+#else
+#define TLC5926_PORT_IO 0
+#endif
+#endif
+
+// What a port register is, to TLC5926Pin (and TLC5926Multi). A host build can make it a class that sees the writes.
+#ifndef TLC5926_PORT_REG
+#define TLC5926_PORT_REG volatile uint8_t
+#endif
+
+// For use inside the classes: needs "debugging" and debug_print()
+#define TLC5926_LOG(level, msg, value) do { \
+    if (TLC5926_LOG_LEVEL >= (level)) { \
+        TLC5926::trace(this, (msg), (value)); \
+        if (debugging) debug_print(msg); \
+        } \
+    } while (0)
+#define TLC5926_WARN(msg) TLC5926_LOG(1, msg, 0)
+#define TLC5926_INFO(msg) TLC5926_LOG(2, msg, 0)
+
+// One pin, looked up once: an edge is then a single port-register write,
+// instead of digitalWrite()'s pin->port table lookups and timer checks.
+// Not for a pin that is running analogWrite() (use digitalWrite to stop the pwm first).
+// An unattached pin (-1) writes to a dummy register, so callers don't need to branch.
+class TLC5926Pin {
+    public:
+#if TLC5926_PORT_IO
+        TLC5926_PORT_REG *out;
+        TLC5926_PORT_REG *in;
+        uint8_t mask;
+#else
+        int pin;
+#endif
+
+        TLC5926Pin() { bind(-1); }
+
+        void bind(int pin_number) {
+#if TLC5926_PORT_IO
+            static TLC5926_PORT_REG nowhere;
+            if (pin_number == -1) {
+                out = in = &nowhere;
+                mask = 0;
+                }
+            else {
+                out = portOutputRegister(digitalPinToPort(pin_number));
+                in = portInputRegister(digitalPinToPort(pin_number));
+                mask = digitalPinToBitMask(pin_number);
+                }
+#else
+            pin = pin_number;
+#endif
+            }
+
+#if TLC5926_PORT_IO
+        // read-modify-write of a shared port, so keep interrupts out (like digitalWrite does)
+        inline void high() { uint8_t sreg = SREG; cli(); *out |= mask; SREG = sreg; }
+        inline void low() { uint8_t sreg = SREG; cli(); *out &= ~mask; SREG = sreg; }
+        inline int read() { return (*in & mask) ? HIGH : LOW; }
+#else
+        inline void high() { if (pin != -1) digitalWrite(pin, HIGH); }
+        inline void low() { if (pin != -1) digitalWrite(pin, LOW); }
+        inline int read() { return pin != -1 ? digitalRead(pin) : LOW; }
+#endif
+        inline void write(int v) { if (v) high(); else low(); }
+        inline void pulse() { high(); low(); }
+    };
+
+// The mode sequences, in PROGMEM. One byte per step, CLK/iOE/LE as bits 0/1/2, see TLC5926::play_steps()
+#define TLC5926_STEP(clk, ioe, le) ((clk) | ((ioe) << 1) | ((le) << 2))
+#define TLC5926_STEP_END 0xFF
+extern const byte NORMAL_MODE_PATTERN[];
+extern const byte SWITCH_MODE_PATTERN[];
+extern const byte ERROR_DETECT_MODE_PATTERN[];
+extern const byte ERROR_DETECT_READY[];
+extern const byte ERROR_DETECT_AGAIN[];
+extern const byte CONFIGURATION_MODE_PATTERN[];
+
+// The SPI peripheral, the way attach_spi() uses it (MSB first, mode 0). TLC5926SPI.h fills it in from SPI.h,
+// so only a sketch that includes that needs the SPI library.
+struct TLC5926Bus {
+    void (*begin)();
+    void (*end)();
+    void (*begin_transaction)(unsigned long clock);
+    byte (*transfer)(byte b);
+    void (*end_transaction)();
+    };
+
+// One deferred call, see TLC5926::defer()
+struct TLC5926Step {
+    byte op;
+    unsigned long arg;
+    };
+
+// TLC5926::stats()
+struct TLC5926Stats {
+    unsigned long clocks; // CLK rising edges
+    unsigned long latches;
+    unsigned long bytes; // shifted a byte at a time (send/all/flush/async...)
+    unsigned long mode_switches;
+    unsigned long send_us, send_max_us; // total, and the longest one
+    unsigned long all_us, all_max_us;
+    unsigned long config_us, config_max_us; // only the ones that weren't already set
+    unsigned long error_detect_us, error_detect_max_us;
+    };
+
+// error_detect() result for one chip
+struct TLC5926Diag {
+    unsigned int status; // raw, 1 is ok
+    unsigned int faults; // the channels that failed: open (or shorted, TLC5927)
+    boolean over_temp; // every channel failed: thermal shutdown (or no LED supply)
+    };
+
 class TLC5926 {
     private:
+         friend class TLC5926Group; // flush() shifts our framebuffer along with the others
+         friend class TLC5926Receiver; // a chip's word at a time through the channel map
          int SDI;
          int CLK;
          int LE;
@@ -14,11 +154,78 @@ class TLC5926 {
          int ct;
          boolean debugging;
          boolean pwm;
+         byte ioe_level; // what on()/off()/brightness() left /OE at, 255 is on: the mode switches put it back
+         boolean spi; // SDI/CLK are the hardware MOSI/SCK
+         boolean spi_live; // SPI peripheral currently owns MOSI/SCK
+         unsigned long spi_clock;
+         static const TLC5926Bus *spi_bus;
+         TLC5926Pin sdi_io, clk_io, le_io, ioe_io, sdo_io;
+         byte *fb; // framebuffer, frame_bytes() long, allocated on first use
+         boolean fb_dirty; // chain doesn't match fb
+         boolean shifted_all_on; // shift-registers are all 1's
+         boolean latched_all_on; // outputs are all on, so error_detect() doesn't need to prime
+         boolean detect_was_replaying;
+         boolean detect_held; // parked in error-detect mode, see detect_hold()
+         byte *configs; // per chip, what we last config()'d
+         byte *widths; // per chip, 8 or 16 bits. NULL is all 16
+         int width_total;
+         TLC5926Stats counters; // there either way, so the class is the same size whatever TLC5926_STATS is
+         unsigned int *remap; // channel_map() nibble tables: [nibble * 16 + value], then the mirrored set. NULL: as is
+         byte *mirrored; // per chip, NULL if none are
+         boolean verifying; // checking SDO against what we shifted, see verify()
+         byte *verify_ring; // what's in the chain, byte-wise: verify_head is the next out of SDO
+         int verify_head;
+         int verify_ct; // how much of the ring is actually known (bit shifts, mode switches, etc. forget it)
+         boolean verify_compared, verify_ok;
+         unsigned int verify_frame_errors;
+         unsigned long verify_errors;
+         boolean configs_known;
+         byte *shadow; // the frame being shifted in the background
+         volatile int async_at; // next byte of shadow
+         volatile boolean async_busy;
+         boolean async_timed; // on the async_timer()
+         unsigned int async_period_us;
+         byte async_chunk; // bytes per tick
+         void (*async_done_fn)();
+         static TLC5926 *async_running;
+         static void async_isr();
+         static boolean (*timer_start)(void (*isr)(), unsigned int period_us);
+         static void (*timer_stop)();
+         TLC5926Step *queue; // deferred steps, a ring
+         byte queue_len, queue_head, queue_ct;
+         boolean replaying; // update() is running steps, so do them for real
+         boolean waiting; // on a deferred delay
+         boolean wait_us; // ...in micros, not millis
+         unsigned long wait_start, wait_for;
+         unsigned long (*now_ms)();
+         unsigned long (*now_us)();
+         enum { STEP_SEND, STEP_ALL, STEP_SEND_BITS, STEP_LATCH, STEP_ON, STEP_OFF, STEP_BRIGHTNESS, STEP_DELAY, STEP_DELAY_US, STEP_FLUSH, STEP_SCROLL };
 
          TLC5926* debug_prefix();
          void debug_print(const char * msg);
-         void do_clk_ioe_le(const int state_list[][3]);
-         void switch_mode(const int pattern[][3]);
+         void do_clk_ioe_le(const byte *steps);
+         void switch_mode(const byte *pattern, const char *name);
+         void restore_ioe();
+         void spi_on();
+         void spi_off();
+         void begin_shift();
+         void shift_byte(byte b);
+         void end_shift();
+         void shift_run(const byte *bytes, int byte_ct);
+         unsigned int to_physical(unsigned int word, int chip); // chip -1: just the map, 16 bits
+         boolean has_8bit_chip();
+         void verify_byte(byte out, byte in);
+         void verify_latched();
+         boolean defer_step(byte op, unsigned long arg);
+         boolean error_detect_begin();
+         unsigned int error_status_word(byte bits, boolean log = true);
+         void error_detect_end();
+         TLC5926* config_chain(const byte *values, byte value);
+         boolean start_async();
+         void async_wait();
+         void async_poll();
+         TLC5926(const TLC5926&); // not copyable: the buffers are ours
+         TLC5926& operator=(const TLC5926&);
         
     public:
          int SDI_pin();
@@ -28,21 +235,73 @@ class TLC5926 {
          int SDO_pin();
 
         TLC5926();
+        ~TLC5926(); // frees the framebuffer (etc.), and stops its background frame if one is going
         // Everybody returns self for chaining, because.
-        TLC5926* debug(boolean v);
+        TLC5926* debug(boolean v); // print log messages, see TLC5926_LOG_LEVEL
+
+        // Replay a PROGMEM step sequence (e.g. NORMAL_MODE_PATTERN). A single port write per step if the pins share a port.
+        static void play_steps(const byte *steps, TLC5926Pin &clk, TLC5926Pin &ioe, TLC5926Pin &le);
+        // Clock the low ct bits of bits onto SDI, MSB first. Inline, so TLC5926Fixed's constant pins fold in.
+        static inline void clock_out(TLC5926Pin &sdi, TLC5926Pin &clk, unsigned int bits, byte ct) {
+            for (unsigned int mask = 1U << (ct - 1); mask; mask >>= 1) {
+                sdi.write(bits & mask);
+                clk.pulse();
+                }
+            }
+
+#if TLC5926_TRACE
+        static void trace(const void *who, const char *msg, unsigned int value);
+#else
+        static void trace(const void *, const char *, unsigned int) { }
+#endif
+        static void dump_trace(Print &out); // and empty it
+        TLC5926Stats stats(); // if TLC5926_STATS
+        TLC5926* reset_stats();
         // FIXME: move chain_ct out -- who uses it?
         TLC5926* attach(int chained_ct, int sdi_pin, int clk_pin, int le_pin, int ioe_pin, int sdo_pin = -1);
         TLC5926* attach(int sdi_pin, int clk_pin, int le_pin, int ioe_pin);
         TLC5926* attach(int chained_ct, int sdi_pin, int clk_pin);
         TLC5926* attach(int sdi_pin, int clk_pin);
+        // SDI->MOSI, CLK->SCK. LE/iOE/SDO are still ordinary pins. Needs #include <TLC5926SPI.h> in the sketch,
+        // else it warns and bit-bangs MOSI/SCK.
+        TLC5926* attach_spi(int chained_ct, int le_pin, int ioe_pin, int sdo_pin = -1, unsigned long clock = 4000000);
+        static void spi_transport(const TLC5926Bus *bus); // TLC5926SPI.h does it. NULL: none
         TLC5926* latch_pulse();
         TLC5926* reset();
         TLC5926* normal_mode();
-        unsigned int error_detect();
-        TLC5926* config(int hi_lo_current, int hi_lo_voltage_band, int voltage_gain);
+        // Mixed chains: widths[i] is chip i's register, 8 (TLC5916/TLC5917) or 16 (the default).
+        // Channels are still numbered from the first chip, no gaps, and the framebuffer, all(), error_detect()
+        // and config() clock exactly that many bits. Call it before using frame() (it starts a new one).
+        TLC5926* chip_widths(const byte *widths, int chip_ct);
+        int chips();
+        int chip_width(int chip);
+        int chip_channel(int chip); // its OUT0
+        // Boards wired out of order: map[i] is the OUT pin that channel i of every chip is wired to
+        // (16 entries, a permutation; a TLC5916 uses the first 8, so with one in the chain map[0..7] has to be 0..7,
+        // else it warns, and it's straight through). mirrored[i] is true for chip i mounted backwards.
+        // Compiled once into nibble lookup tables, then whole frames are translated as they're shifted
+        // (flush(), flush_async(), shift_bytes() of a whole frame, TLC5926Receiver's frames),
+        // and send()/shift() words get the map (not mirroring).
+        // send_bits(), partial shift_bytes() and TLC5926Group are physical order.
+        // channel_map(NULL) is straight through again.
+        TLC5926* channel_map(const byte *map, const boolean *mirrored = NULL, int chip_ct = 0);
+        unsigned int error_detect(); // just the last chip (on SDO)
+        // Whole chain, in one pass. chip_ct has to be >= the chain. [0] is the first chip. Returns chips read.
+        int error_detect(unsigned int *status, int chip_ct);
+        int error_detect(TLC5926Diag *diag, int chip_ct);
+        // Stay in error-detect mode and read it again and again (e.g. TLC5926Scanner: 16 inputs per chip).
+        // Much cheaper than error_detect() each time. Don't shift anything else until detect_release().
+        boolean detect_hold();
+        int detect_sample(unsigned int *status, int chip_ct); // like error_detect(status,..), no logging
+        int isr_detect(unsigned int *status, int chip_ct); // detect_sample() for a timer interrupt: doesn't wait on send_async()
+        TLC5926* detect_release(); // back to normal mode
+        TLC5926* config(int hi_lo_current, int hi_lo_voltage_band, int voltage_gain); // all chips
+        // a different config_value() per chip, [0] is the first chip. One config-mode pass.
+        TLC5926* config(const byte *values, int chip_ct);
+        static byte config_value(int hi_lo_current, int hi_lo_voltage_band, int voltage_gain);
         TLC5926* off();
         TLC5926* on();
-        void shift(unsigned int pattern); // not chainable!
+        void shift(unsigned int pattern); // not chainable! always 16 bits
         TLC5926* send(unsigned int pattern);
         TLC5926* all(int hilo);
         TLC5926* send_bits(int ct, short int bits, int delay_between = 0);
@@ -51,6 +310,68 @@ class TLC5926 {
         TLC5926* delayMicroseconds(unsigned int duration);
         TLC5926* flash(unsigned int on = 50, unsigned int bracket = 200, boolean leave_on = true);
         unsigned short int read_sdo();
+        // Check every byte shifted against what comes out of SDO at the same time (no extra clocks):
+        // after a chain's worth of bytes, SDO should be giving back what we shifted a chain ago.
+        // So a bad link or too fast a clock shows up as bit errors. Needs SDO (on MISO, if attach_spi()).
+        // Only byte shifts (send/all/flush/async, etc.) are checked, anything bit-wise starts it over.
+        TLC5926* verify(boolean on); // and zeroes the counts
+        boolean verified(); // the last latched frame came back right (false if it couldn't be checked)
+        unsigned long bit_errors(); // since verify(true)
+
+        // Framebuffer for the whole chain.
+        // Channel 0 is OUT0 of the first chip (the one on SDI), channel 16 is OUT0 of the next, etc.
+        // Laid out in shift order: frame()[0] is the high byte of the last chip, frame()[frame_bytes()-1]
+        // is the low byte of the first chip. So, a frame is MSB-first, just like send().
+        // flush() does nothing if nothing changed since the last flush().
+        // Other shifting (send(), all(), etc.) marks it changed.
+        int channels();
+        int frame_bytes();
+        byte* frame(); // NULL if not attached (or no memory)
+        TLC5926* set(int channel, int hilo = HIGH);
+        TLC5926* clear(int channel);
+        TLC5926* toggle(int channel);
+        int get(int channel);
+        TLC5926* set_word(int chip, unsigned int pattern); // just the low byte for an 8 bit chip
+        TLC5926* set_bytes(int offset, const byte *bytes, int byte_ct);
+        TLC5926* fill(int hilo);
+        TLC5926* flush();
+        boolean dirty();
+        void shift_bytes(const byte *bytes, int byte_ct); // not chainable! doesn't latch
+        // From a timer interrupt (TLC5926BCM, etc.): shift_bytes()/latch_pulse() straight to the pins, without
+        // deferring, waiting on a background frame, or handing MOSI/SCK back and forth. isr_ready() first, outside the isr.
+        TLC5926* isr_ready();
+        void isr_shift(const byte *bytes, int byte_ct);
+        TLC5926* isr_latch();
+        // The chain moves itself: clock in just ct (up to 16) new bits, MSB first, and latch.
+        // Every channel moves up ct, the last new bit is channel 0. The framebuffer moves along too,
+        // so it stays flushed if it was.
+        TLC5926* scroll(int ct, short int bits);
+
+        // Non-blocking: after defer(), send/all/send_bits/scroll/latch_pulse/on/off/brightness/flush/delay/
+        // delayMicroseconds/flash are queued (in your steps[], no malloc), and run by update().
+        // Call update() often (every loop()). It runs steps until it hits a delay that hasn't finished.
+        // defer(NULL,0) goes back to "right now" (and drops anything queued).
+        // config/error_detect/normal_mode/reset always run right away, so call them with nothing queued.
+        TLC5926* defer(TLC5926Step *steps, byte len);
+        boolean update(); // true if there is more to do
+        boolean busy();
+        // where update() gets the time, e.g. a fake clock for testing. Default millis()/micros()
+        TLC5926* clock(unsigned long (*millis_fn)(), unsigned long (*micros_fn)());
+
+        // Background shifting: the frame is copied to a second buffer, and shifted out a few bytes at a time
+        // on TLC5926Timer (SPI if attach_spi()), then latched. So you can build the next frame meanwhile.
+        // Returns false if one is still going, on this or any other TLC5926 (one at a time, they share the timer).
+        // Other shifting waits for it to finish.
+        // The timer needs #include <TLC5926TimerISR.h> in the sketch (and AVR). Else call async_step() from your own,
+        // or not: without a timer, async_done() (and anything that has to wait for it) shifts the next chunk itself.
+        boolean send_async(const byte *frame); // frame_bytes() long, like frame()
+        boolean flush_async(); // the framebuffer (if changed)
+        boolean async_done(); // no timer: does the next chunk
+        TLC5926* on_async_done(void (*callback)()); // called from the isr, after the latch
+        TLC5926* async_rate(unsigned int period_us, byte bytes_per_tick); // default 100us, 2 bytes
+        void async_step();
+        // what runs async_step(): start(isr, period_us) true if it will, stop(). TLC5926TimerISR.h sets TLC5926Timer
+        static void async_timer(boolean (*start)(void (*isr)(), unsigned int period_us), void (*stop)());
 
 
 
@@ -0,0 +1,143 @@
+#include <TLC5926Anim.h>
+
+// where the decoder is
+enum { ANIM_AT_OP, ANIM_AT_DURATION_LO, ANIM_AT_DURATION_HI, ANIM_AT_CONTROL, ANIM_AT_REPEAT, ANIM_AT_LITERAL };
+// what feed() did
+enum { ANIM_MORE, ANIM_SHOWN, ANIM_ENDED };
+
+TLC5926Anim::TLC5926Anim() {
+    tlc = NULL;
+    start = at = NULL;
+    stream = NULL;
+    is_playing = false;
+    frame_start = 0;
+    duration = 0;
+    state = ANIM_AT_OP;
+    op = 0;
+    fb_at = 0;
+    run = 0;
+    framed = false;
+    }
+
+TLC5926Anim* TLC5926Anim::attach(TLC5926 *t) {
+    tlc = t;
+    return this;
+    }
+
+TLC5926Anim* TLC5926Anim::play(const byte *progmem_data) {
+    start = at = progmem_data;
+    stream = NULL;
+    duration = 0;
+    state = ANIM_AT_OP;
+    framed = false;
+    is_playing = tlc && tlc->frame();
+    if (is_playing) is_playing = next_frame();
+    return this;
+    }
+
+TLC5926Anim* TLC5926Anim::play(Stream &s) {
+    start = at = NULL;
+    stream = &s;
+    duration = 0;
+    state = ANIM_AT_OP;
+    framed = false;
+    is_playing = tlc && tlc->frame();
+    if (is_playing) is_playing = next_frame();
+    return this;
+    }
+
+TLC5926Anim* TLC5926Anim::stop() {
+    is_playing = false;
+    return this;
+    }
+
+boolean TLC5926Anim::playing() { return is_playing; }
+
+int TLC5926Anim::next_byte() {
+    if (stream) return stream->available() > 0 ? stream->read() : -1;
+    return pgm_read_byte(at++);
+    }
+
+byte TLC5926Anim::feed(byte b) {
+    // one more byte of the animation. RLE payloads go straight into the framebuffer,
+    // set_bytes() marks it dirty only if a byte changes
+    switch (state) {
+        case ANIM_AT_OP:
+            op = b;
+            if (op & TLC5926_ANIM_DURATION) {
+                state = ANIM_AT_DURATION_LO;
+                return ANIM_MORE;
+                }
+            return op_done();
+        case ANIM_AT_DURATION_LO:
+            duration = b;
+            state = ANIM_AT_DURATION_HI;
+            return ANIM_MORE;
+        case ANIM_AT_DURATION_HI:
+            duration |= b << 8;
+            return op_done();
+        case ANIM_AT_CONTROL:
+            run = (b & 0x7F) + 1;
+            state = b & 0x80 ? ANIM_AT_REPEAT : ANIM_AT_LITERAL;
+            return ANIM_MORE;
+        }
+
+    // a payload byte: the repeated one (all of the run), or the next literal
+    const byte *fb = tlc->frame();
+    int n = tlc->frame_bytes();
+    boolean xor_it = (op & TLC5926_ANIM_OP) == TLC5926_ANIM_XOR;
+    do {
+        byte v = xor_it ? fb[fb_at] ^ b : b;
+        tlc->set_bytes(fb_at++, &v, 1);
+        run--;
+        } while (state == ANIM_AT_REPEAT && run && fb_at < n);
+    if (!run) state = ANIM_AT_CONTROL;
+    if (fb_at < n) return ANIM_MORE;
+
+    tlc->flush();
+    state = ANIM_AT_OP;
+    framed = true;
+    frame_start = millis();
+    return ANIM_SHOWN;
+    }
+
+byte TLC5926Anim::op_done() {
+    // the op (and duration) is in
+    state = ANIM_AT_OP;
+    switch (op & TLC5926_ANIM_OP) {
+        case TLC5926_ANIM_KEY:
+        case TLC5926_ANIM_XOR:
+            fb_at = 0;
+            state = ANIM_AT_CONTROL;
+            return ANIM_MORE;
+        case TLC5926_ANIM_HOLD:
+            frame_start = millis();
+            return ANIM_SHOWN;
+        }
+    // END
+    if (!(op & TLC5926_ANIM_LOOP) || !start) return ANIM_ENDED;
+    if (!framed) return ANIM_ENDED; // around again wouldn't show anything either
+    framed = false;
+    at = start;
+    return ANIM_MORE;
+    }
+
+boolean TLC5926Anim::next_frame() {
+    // false if it ended. Out of bytes (a stream) is "still playing", it goes on from here next time
+    for (;;) {
+        int b = next_byte();
+        if (b < 0) return true;
+        switch (feed(b)) {
+            case ANIM_SHOWN: return true;
+            case ANIM_ENDED: return false;
+            }
+        }
+    }
+
+boolean TLC5926Anim::update() {
+    if (!is_playing) return false;
+    // (partway through a frame, the duration may already be the next one's)
+    if (state == ANIM_AT_OP && millis() - frame_start < duration) return true;
+    is_playing = next_frame();
+    return is_playing;
+    }
@@ -0,0 +1,75 @@
+#ifndef TLC5926Anim_h
+#define TLC5926Anim_h
+
+/*
+    Plays compact animations (in PROGMEM, or from a Stream) into a TLC5926's framebuffer.
+
+        #include "my_anim.h" // from extras/anim_encode.py: const byte my_anim[] PROGMEM = {...};
+        TLC5926 tlc;
+        TLC5926Anim anim;
+
+        tlc.attach(2, SDI_pin, CLK_pin, LE_pin, iOE_pin);
+        anim.attach(&tlc)->play(my_anim);
+        ...
+        anim.update(); // in loop(), doesn't block
+
+    Format: a sequence of frames, each
+        op byte
+            bits 7-6: 00 KEY  the payload is the frame
+                      01 XOR  the payload is XOR'd onto the current frame
+                      10 HOLD no payload, just wait (again)
+                      11 END  bit 0 set: loop to the start, otherwise stop. Also stops if there wasn't a
+                              KEY/XOR frame since the start (only HOLDs, or nothing), rather than spin
+            bit 5: a duration follows, 2 bytes, little-endian, ms. Otherwise the previous duration.
+        [duration]
+        payload: frame_bytes() bytes (same order as TLC5926::frame()), run-length coded:
+            control byte c, then
+                c & 0x80: one byte, repeated (c & 0x7F) + 1 times
+                otherwise: c + 1 literal bytes
+    The frames decode straight into the framebuffer (no other copy), and flush() only shifts if it changed.
+    From a Stream, update() takes whatever has arrived (available()) and never waits: a frame that's only partly
+    there is picked up again on the next update(), and shows when its last byte does.
+*/
+
+#include <TLC5926.h>
+
+#define TLC5926_ANIM_KEY 0x00
+#define TLC5926_ANIM_XOR 0x40
+#define TLC5926_ANIM_HOLD 0x80
+#define TLC5926_ANIM_END 0xC0
+#define TLC5926_ANIM_OP 0xC0
+#define TLC5926_ANIM_DURATION 0x20
+#define TLC5926_ANIM_LOOP 0x01
+
+class TLC5926Anim {
+    private:
+        TLC5926 *tlc;
+        const byte *start; // PROGMEM
+        const byte *at;
+        Stream *stream;
+        boolean is_playing;
+        unsigned long frame_start;
+        unsigned int duration;
+        // the decoder, a byte at a time, so it can stop anywhere when the stream runs dry
+        byte state; // ANIM_AT_*
+        byte op;
+        int fb_at; // next framebuffer byte
+        byte run; // bytes left in the run
+        boolean framed; // a KEY/XOR frame since the start (or the last loop), so looping gets somewhere
+
+        int next_byte(); // -1 if the stream ran dry
+        byte feed(byte b);
+        byte op_done();
+        boolean next_frame();
+
+    public:
+        TLC5926Anim();
+        TLC5926Anim* attach(TLC5926 *tlc);
+        TLC5926Anim* play(const byte *progmem_data);
+        TLC5926Anim* play(Stream &stream); // END/loop just stops. Doesn't wait for bytes
+        TLC5926Anim* stop();
+        boolean playing();
+        boolean update(); // true while playing
+    };
+
+#endif
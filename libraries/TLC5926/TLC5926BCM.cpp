@@ -0,0 +1,98 @@
+#include <TLC5926BCM.h>
+#include <TLC5926Timer.h>
+
+TLC5926BCM *TLC5926BCM::running = NULL;
+
+TLC5926BCM::TLC5926BCM() {
+    tlc = NULL;
+    planes = NULL;
+    bytes = 0;
+    plane = 0;
+    base_us = 0;
+    timed = false;
+    }
+
+TLC5926BCM* TLC5926BCM::attach(TLC5926 *t) {
+    if (planes) return this; // already
+    bytes = t->frame_bytes();
+    planes = (byte*) calloc(8 * bytes, 1);
+    if (planes) tlc = t;
+    return this;
+    }
+
+TLC5926BCM* TLC5926BCM::set(int channel, byte intensity) {
+    if (!tlc || channel < 0 || channel >= tlc->channels()) return this;
+
+    // same layout as TLC5926::frame(): channel 0 is the last bit shifted
+    byte *at = planes + bytes - 1 - (channel >> 3);
+    byte mask = 1 << (channel & 7);
+    for (int p = 0; p < 8; p++, at += bytes) {
+        if (intensity & (1 << p)) *at |= mask;
+        else *at &= ~mask;
+        }
+    return this;
+    }
+
+byte TLC5926BCM::get(int channel) {
+    if (!tlc || channel < 0 || channel >= tlc->channels()) return 0;
+
+    const byte *at = planes + bytes - 1 - (channel >> 3);
+    byte mask = 1 << (channel & 7);
+    byte intensity = 0;
+    for (int p = 0; p < 8; p++, at += bytes) {
+        if (*at & mask) intensity |= 1 << p;
+        }
+    return intensity;
+    }
+
+TLC5926BCM* TLC5926BCM::fill(byte intensity) {
+    if (!tlc) return this;
+    for (int p = 0; p < 8; p++) memset(planes + p * bytes, (intensity & (1 << p)) ? 0xFF : 0, bytes);
+    return this;
+    }
+
+boolean TLC5926BCM::begin(unsigned int base) {
+    if (!tlc || tlc->LE_pin() == -1) return false;
+    end();
+
+    // The next plane is shifted during the shortest slot, so that slot has to be longer than a shift.
+    unsigned long start = micros();
+    tlc->shift_bytes(planes, bytes);
+    unsigned long shift_us = micros() - start;
+    tlc->latch_pulse();
+    unsigned long shortest = base > shift_us + 8 ? base : shift_us + 8;
+    if (shortest > 255) return false; // base << 7 has to fit the timer. Too long a chain, try SPI.
+    base_us = shortest;
+    plane = 0;
+
+    tlc->shift_bytes(planes + bytes, bytes); // plane 1, latched at the first interrupt
+    tlc->isr_ready();
+
+    running = this;
+    timed = TLC5926Timer::start(timer_isr, TLC5926Timer::us_to_ticks(base_us));
+    return timed;
+    }
+
+void TLC5926BCM::end() {
+    if (running == this) {
+        if (timed) TLC5926Timer::stop();
+        running = NULL;
+        timed = false;
+        }
+    }
+
+void TLC5926BCM::timer_isr() {
+    if (running) running->isr();
+    }
+
+unsigned int TLC5926BCM::isr() {
+    // the plane shifted last time goes up now, for (base << plane)
+    plane = (plane + 1) & 7;
+    tlc->isr_latch();
+    unsigned int slot_us = base_us << plane;
+    if (timed) TLC5926Timer::next(TLC5926Timer::us_to_ticks(slot_us));
+
+    // and get the next one ready
+    tlc->isr_shift(planes + ((plane + 1) & 7) * bytes, bytes);
+    return slot_us;
+    }
@@ -0,0 +1,51 @@
+#ifndef TLC5926BCM_h
+#define TLC5926BCM_h
+
+/*
+    Per-channel brightness (0-255) by Binary Code Modulation, in the background.
+
+    Each channel's intensity is split into 8 bit-planes. Plane p is latched and shown for (base << p),
+    so the on-time of a channel adds up to its intensity. While one plane is showing, the next one is shifted in,
+    and latched at the next timer interrupt, so loop() isn't blocked.
+
+        TLC5926 tlc;
+        TLC5926BCM bcm;
+
+        tlc.attach(2, SDI_pin, CLK_pin, LE_pin, iOE_pin); // needs LE
+        bcm.attach(&tlc)->set(0, 255)->set(1, 16)->set(17, 128);
+        bcm.begin(); // base slot in us, 0 is "as short as the shift allows"
+
+    set() only touches that channel's bit in each plane (8 bit-ops), the planes are never rebuilt.
+    A whole cycle is 255 * base, so shorter chains (or SPI) can refresh faster.
+    begin() fails if the shift takes longer than 255us (about 15 chips bit-banged): use attach_spi().
+
+    Uses TLC5926Timer (Timer1 on AVR): #include <TLC5926TimerISR.h> in the sketch.
+    Without it (or not on AVR), begin() returns false, and you call isr() from your own timer:
+    it returns how long (us) until it should be called again.
+*/
+
+#include <TLC5926.h>
+
+class TLC5926BCM {
+    private:
+        TLC5926 *tlc;
+        byte *planes; // 8 x frame_bytes, plane 0 first
+        int bytes;
+        volatile byte plane; // showing now
+        unsigned int base_us;
+        boolean timed;
+        static TLC5926BCM *running;
+        static void timer_isr();
+
+    public:
+        TLC5926BCM();
+        TLC5926BCM* attach(TLC5926 *tlc);
+        TLC5926BCM* set(int channel, byte intensity);
+        byte get(int channel);
+        TLC5926BCM* fill(byte intensity);
+        boolean begin(unsigned int base = 0);
+        void end();
+        unsigned int isr();
+    };
+
+#endif
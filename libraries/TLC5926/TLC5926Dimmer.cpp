@@ -0,0 +1,172 @@
+#include <TLC5926Dimmer.h>
+#include <TLC5926Timer.h>
+#include "pins_arduino.h"
+
+// Timer1's registers, and the core knows which pins are on it: AVR (or a host stand-in of its registers)
+#if defined(TCCR1A) && defined(TIMER1A) && defined(TIMER1B)
+#define TLC5926_HAS_TIMER1_PWM 1
+#ifdef __AVR__
+#include <avr/interrupt.h>
+#endif
+#endif
+
+static const unsigned int WIDE_TOP = 4095; // 12 bits
+static const unsigned int DITHER_US = 1000; // 8-bit mode tick
+
+// 4095 * (0.7x^2 + 0.3x^3), x = level/255: close to gamma 2.2, in integers so it's a compile-time constant
+static constexpr unsigned int gamma12(unsigned long long level) {
+    return (4095ULL * level * level * (1785 + 3 * level) + 165813750ULL / 2) / 165813750ULL;
+    }
+
+#define G4(n) gamma12(n), gamma12(n + 1), gamma12(n + 2), gamma12(n + 3)
+#define G16(n) G4(n), G4(n + 4), G4(n + 8), G4(n + 12)
+#define G64(n) G16(n), G16(n + 16), G16(n + 32), G16(n + 48)
+static const unsigned int GAMMA[256] PROGMEM = { G64(0), G64(64), G64(128), G64(192) };
+#undef G4
+#undef G16
+#undef G64
+
+TLC5926Dimmer *TLC5926Dimmer::running = NULL;
+
+TLC5926Dimmer::TLC5926Dimmer() {
+    iOE = -1;
+    wide = false;
+    now = target = 0;
+    step = 0;
+    ticks_left = 0;
+    dither = 0;
+    }
+
+unsigned int TLC5926Dimmer::gamma(byte level) {
+    return pgm_read_word(&GAMMA[level]);
+    }
+
+TLC5926Dimmer* TLC5926Dimmer::attach(TLC5926 *tlc) {
+    iOE = tlc->iOE_pin();
+    if (iOE == -1) return this;
+    pinMode(iOE, OUTPUT);
+    running = this;
+
+#ifdef TLC5926_HAS_TIMER1_PWM
+    byte timer = digitalPinToTimer(iOE);
+    if (timer == TIMER1A || timer == TIMER1B) {
+        // Timer1 is ours from now on: TLC5926Timer::start() would wreck the pwm setup, so it's refused
+        if (!TLC5926Timer::reserve()) {
+            iOE = -1; // an engine has it running: not attached
+            running = NULL;
+            return this;
+            }
+        wide = true;
+        uint8_t sreg = SREG;
+        cli();
+        // fast pwm, TOP = ICR1, no prescale. Non-inverting, so output() counts /OE's low (on) time down from TOP
+        TCCR1A = _BV(WGM11);
+        connect();
+        TCCR1B = _BV(WGM13) | _BV(WGM12) | _BV(CS10);
+        ICR1 = WIDE_TOP;
+        TLC5926Timer::overflow_isr = timer_isr; // if TLC5926TimerISR.h linked the vector
+        SREG = sreg;
+        output();
+        return this;
+        }
+#endif
+
+    TLC5926Timer::start(timer_isr, TLC5926Timer::us_to_ticks(DITHER_US));
+    output();
+    return this;
+    }
+
+void TLC5926Dimmer::timer_isr() {
+    if (running) running->tick();
+    }
+
+void TLC5926Dimmer::connect() {
+    // /OE to Timer1's pwm. digitalWrite() on it (TLC5926's on()/off()/config()...) clears COM1x1, back to a plain pin
+#ifdef TLC5926_HAS_TIMER1_PWM
+    if (!wide) return;
+    uint8_t sreg = SREG;
+    cli();
+    if (digitalPinToTimer(iOE) == TIMER1A) TCCR1A |= _BV(COM1A1);
+    else TCCR1A |= _BV(COM1B1);
+    SREG = sreg;
+#endif
+    }
+
+void TLC5926Dimmer::output() {
+    if (iOE == -1) return;
+    // interpolate between the table entries, so a slow fade is smooth
+    byte i = now >> 16;
+    byte frac = now >> 8;
+    unsigned int duty = gamma(i);
+    if (i < 255) duty += ((unsigned long)(gamma(i + 1) - duty) * frac) >> 8;
+
+#ifdef TLC5926_HAS_TIMER1_PWM
+    if (wide) {
+        // high (off) from BOTTOM to OCR, so low (on) for duty counts
+        if (digitalPinToTimer(iOE) == TIMER1A) OCR1A = WIDE_TOP - duty;
+        else OCR1B = WIDE_TOP - duty;
+        return;
+        }
+#endif
+
+    // 8 bits now, and carry the low 4 bits along to the next tick
+    dither += duty & 0x0F;
+    byte duty8 = duty >> 4;
+    if (dither >= 16) {
+        dither -= 16;
+        if (duty8 < 255) duty8++;
+        }
+    analogWrite(iOE, 255 - duty8); // inverted
+    }
+
+void TLC5926Dimmer::tick() {
+    if (ticks_left) {
+        now += step;
+        if (--ticks_left == 0) now = target;
+        }
+    else if (wide) {
+#ifdef TLC5926_HAS_TIMER1_PWM
+        TIMSK1 &= ~_BV(TOIE1); // done, until the next fade()
+#endif
+        return;
+        }
+    output();
+    }
+
+TLC5926Dimmer* TLC5926Dimmer::level(byte level) {
+    noInterrupts();
+    ticks_left = 0;
+    now = target = (unsigned long)level << 16;
+    interrupts();
+    connect();
+    output();
+    return this;
+    }
+
+byte TLC5926Dimmer::level() {
+    return now >> 16;
+    }
+
+TLC5926Dimmer* TLC5926Dimmer::fade(byte level, unsigned long duration_ms) {
+    // 12-bit: one tick per pwm cycle, on Timer1's overflow. Without the vector, tick() is yours at ~1kHz either way
+    boolean overflows = wide && TLC5926Timer::claimed();
+    unsigned long ticks = overflows
+        ? duration_ms * (F_CPU / 1000 / 64) / ((WIDE_TOP + 1) / 64) // one per pwm cycle
+        : duration_ms * 1000 / DITHER_US;
+    if (!ticks) return this->level(level);
+    connect();
+
+    noInterrupts();
+    target = (unsigned long)level << 16;
+    step = ((long)target - (long)now) / (long)ticks;
+    ticks_left = ticks;
+#ifdef TLC5926_HAS_TIMER1_PWM
+    if (overflows) TIMSK1 |= _BV(TOIE1);
+#endif
+    interrupts();
+    return this;
+    }
+
+boolean TLC5926Dimmer::fading() {
+    return ticks_left != 0;
+    }
@@ -0,0 +1,57 @@
+#ifndef TLC5926Dimmer_h
+#define TLC5926Dimmer_h
+
+/*
+    Global brightness on /OE, gamma corrected, with background fades.
+
+        TLC5926 tlc;
+        TLC5926Dimmer dimmer;
+
+        tlc.attach(1, SDI_pin, CLK_pin, LE_pin, 9); // /OE on pin 9 (OC1A on an Uno) for 12-bit dimming
+        dimmer.attach(&tlc)->level(128); // perceptual: 128 is "half as bright"
+        dimmer.fade(10, 2000); // to 10 over 2 seconds, returns right away
+
+    Levels are 0-255, and go through a gamma (about 2.2) table built at compile time, so equal steps look equal.
+    * If /OE is on a Timer1 pin (9/10 on an Uno, 11/12 on a Mega), that's 12-bit pwm (~3.9kHz at 16MHz),
+      and the fade steps on the Timer1 overflow interrupt, if the sketch has #include <TLC5926TimerISR.h>.
+      Without it, call tick() from your own ~1kHz timer for fades.
+    * On any other pwm pin, it's 8-bit analogWrite, dithered over time to get the extra 4 bits,
+      and the fade/dither runs on TLC5926Timer (so not together with TLC5926BCM, etc.), if the sketch has
+      #include <TLC5926TimerISR.h>. Without it (or not AVR), call tick() from your own ~1kHz timer.
+
+    TLC5926's on()/off()/config()/error_detect() take /OE back (digitalWrite() clears COM1x1, which unhooks it from
+    Timer1): call level() or fade() again after them, they hook it back up. A fade already going leaves /OE alone until then.
+
+    12-bit mode sets Timer1 up for itself, for good: after that, TLC5926Timer::start() returns false, so TLC5926BCM,
+    TLC5926Matrix, TLC5926Scanner and send_async()'s background shift won't start (the async one polls instead).
+    And if one of them is already running, attach() doesn't, and level()/fade() do nothing. Pick one.
+*/
+
+#include <TLC5926.h>
+
+class TLC5926Dimmer {
+    private:
+        int iOE;
+        boolean wide; // 12-bit Timer1 pwm
+        volatile unsigned long now; // level, 8.16 fixed point
+        volatile unsigned long target;
+        volatile long step; // per tick
+        volatile unsigned long ticks_left;
+        byte dither; // carried fraction, 8-bit mode
+        static TLC5926Dimmer *running;
+        void output();
+        void connect();
+
+    public:
+        TLC5926Dimmer();
+        TLC5926Dimmer* attach(TLC5926 *tlc);
+        TLC5926Dimmer* level(byte level);
+        byte level();
+        TLC5926Dimmer* fade(byte level, unsigned long duration_ms);
+        boolean fading();
+        void tick(); // the isr
+        static void timer_isr(); // tick()'s the attached one
+        static unsigned int gamma(byte level); // 0-4095
+    };
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef TLC5926Fixed_h
+#define TLC5926Fixed_h
+
+/*
+    TLC5926 with the pins fixed at compile time.
+
+        // SDI=2, CLK=3, LE=4, /OE=5, no SDO
+        TLC5926Fixed<2,3,4,5> shift_register1;
+        shift_register1.attach(2); // 2 chained
+        shift_register1.send(0xAAAA);
+
+    Same behavior as TLC5926's shift/send/all/send_bits/latch_pulse/on/off/normal_mode,
+    but the "is LE/iOE hooked up?" tests are constants, so the unused branches compile away.
+    The port/mask for each pin is still looked up once at attach() (the Arduino pin->port tables are in PROGMEM,
+    so not compile-time), then each edge is a single port-register write.
+
+    No debug messages, no SPI, no diagnostics/config: use TLC5926 for those.
+*/
+
+#include <TLC5926.h>
+
+template <int SDI_PIN, int CLK_PIN, int LE_PIN = -1, int IOE_PIN = -1, int SDO_PIN = -1>
+class TLC5926Fixed {
+    private:
+        int ct;
+        TLC5926Pin sdi_io, clk_io, le_io, ioe_io;
+
+    public:
+        TLC5926Fixed() { ct = 0; }
+
+        int SDI_pin() { return SDI_PIN; }
+        int CLK_pin() { return CLK_PIN; }
+        int LE_pin() { return LE_PIN; }
+        int iOE_pin() { return IOE_PIN; }
+        int SDO_pin() { return SDO_PIN; }
+
+        TLC5926Fixed* attach(int chained_ct = 1) {
+            if (ct) return this;
+            ct = chained_ct;
+
+            sdi_io.bind(SDI_PIN);
+            clk_io.bind(CLK_PIN);
+            le_io.bind(LE_PIN);
+            ioe_io.bind(IOE_PIN);
+
+            pinMode(CLK_PIN, OUTPUT);
+            clk_io.low();
+            pinMode(SDI_PIN, OUTPUT);
+            if (LE_PIN != -1) {
+                pinMode(LE_PIN, OUTPUT);
+                le_io.low();
+                }
+            if (IOE_PIN != -1) {
+                pinMode(IOE_PIN, OUTPUT);
+                on();
+                }
+            if (SDO_PIN != -1) pinMode(SDO_PIN, INPUT); // don't sink
+            return this;
+            }
+
+        TLC5926Fixed* latch_pulse() {
+            if (LE_PIN != -1) le_io.pulse();
+            return this;
+            }
+
+        TLC5926Fixed* on() {
+            if (IOE_PIN != -1) ioe_io.low(); // inverted
+            return this;
+            }
+
+        TLC5926Fixed* off() {
+            if (IOE_PIN != -1) ioe_io.high(); // inverted
+            return this;
+            }
+
+        TLC5926Fixed* normal_mode() {
+            if (LE_PIN != -1 && IOE_PIN != -1) {
+                TLC5926::play_steps(SWITCH_MODE_PATTERN, clk_io, ioe_io, le_io);
+                TLC5926::play_steps(NORMAL_MODE_PATTERN, clk_io, ioe_io, le_io);
+                }
+            return this;
+            }
+
+        // the bits are TLC5926::clock_out(), like TLC5926's bit-banging: what's compiled away is the LE/iOE tests
+        void shift(unsigned int pattern) { // not chainable!
+            TLC5926::clock_out(sdi_io, clk_io, pattern, 16);
+            }
+
+        TLC5926Fixed* send(unsigned int pattern) {
+            shift(pattern);
+            return latch_pulse();
+            }
+
+        TLC5926Fixed* all(int hilo) {
+            sdi_io.write(hilo); // a level, not bits: SDI once, then just clocks
+            for (int i = ct * 16; i > 0; i--) clk_io.pulse();
+            return latch_pulse();
+            }
+
+        TLC5926Fixed* send_bits(int ct, short int bits) {
+            if (ct > 0) TLC5926::clock_out(sdi_io, clk_io, (unsigned short) bits, ct);
+            return latch_pulse();
+            }
+    };
+
+#endif
@@ -0,0 +1,90 @@
+#include <TLC5926Group.h>
+
+TLC5926Group::TLC5926Group() {
+    member_ct = 0;
+    CLK = -1;
+    le_ct = ioe_ct = 0;
+    }
+
+byte TLC5926Group::add_pin(int pin, int *pins, TLC5926Pin *io, byte ct) {
+    if (pin == -1) return ct;
+    for (byte i = 0; i < ct; i++) if (pins[i] == pin) return ct; // shared
+    pins[ct] = pin;
+    io[ct].bind(pin);
+    return ct + 1;
+    }
+
+TLC5926Group* TLC5926Group::add(TLC5926 *member) {
+    if (member_ct >= 8 || !member->frame()) return this;
+    if (member_ct && member->CLK_pin() != CLK) return this; // has to share the clock
+
+    CLK = member->CLK_pin();
+    clk_io.bind(CLK);
+    sdi_io[member_ct].bind(member->SDI_pin());
+    members[member_ct++] = member;
+    le_ct = add_pin(member->LE_pin(), le_pins, le_io, le_ct);
+    ioe_ct = add_pin(member->iOE_pin(), ioe_pins, ioe_io, ioe_ct);
+    return this;
+    }
+
+int TLC5926Group::size() { return member_ct; }
+
+boolean TLC5926Group::dirty() {
+    for (byte m = 0; m < member_ct; m++) if (members[m]->dirty()) return true;
+    return false;
+    }
+
+TLC5926Group* TLC5926Group::flush() {
+    if (!dirty()) return this;
+
+    int longest = 0;
+    for (byte m = 0; m < member_ct; m++) {
+        members[m]->async_wait();
+        members[m]->spi_off(); // we bit-bang MOSI/SCK
+        if (members[m]->frame_bytes() > longest) longest = members[m]->frame_bytes();
+        }
+
+    for (int i = 0; i < longest; i++) {
+        for (byte mask = 0x80; mask; mask >>= 1) {
+            for (byte m = 0; m < member_ct; m++) {
+                // right-aligned: a shorter chain starts late, with zeros that fall off its end
+                int at = i - (longest - members[m]->frame_bytes());
+                sdi_io[m].write(at >= 0 && (members[m]->fb[at] & mask));
+                }
+            clk_io.pulse();
+            }
+        }
+
+    latch_pulse();
+    for (byte m = 0; m < member_ct; m++) {
+#if TLC5926_STATS
+        // every chain saw every clock, padding and all
+        members[m]->counters.bytes += longest;
+        members[m]->counters.clocks += 8UL * longest;
+#endif
+        members[m]->fb_dirty = false;
+        members[m]->shifted_all_on = members[m]->latched_all_on = false; // error_detect() re-primes
+        members[m]->verify_ct = 0; // bit-banged here, not checked
+        }
+    return this;
+    }
+
+TLC5926Group* TLC5926Group::latch_pulse() {
+    // all the LE's up, then down: the same edge, as near as we can
+    for (byte i = 0; i < le_ct; i++) le_io[i].high();
+    for (byte i = 0; i < le_ct; i++) le_io[i].low();
+#if TLC5926_STATS
+    for (byte m = 0; m < member_ct; m++) if (members[m]->LE_pin() != -1) members[m]->counters.latches++;
+#endif
+    return this;
+    }
+
+TLC5926Group* TLC5926Group::on() {
+    for (byte i = 0; i < ioe_ct; i++) ioe_io[i].low(); // inverted
+    return this;
+    }
+
+TLC5926Group* TLC5926Group::off() {
+    for (byte i = 0; i < ioe_ct; i++) ioe_io[i].high(); // inverted
+    return this;
+    }
@@ -0,0 +1,49 @@
+#ifndef TLC5926Group_h
+#define TLC5926Group_h
+
+/*
+    Several TLC5926's (each with its own SDI) on one CLK, updated together: one pass, one latch.
+
+        TLC5926 left, right;
+        TLC5926Group panels;
+
+        left.attach(4, 2, 8, 9, 10); // 4 chips, SDI=2, CLK=8, LE=9, /OE=10
+        right.attach(2, 3, 8, 9, 10); // 2 chips, SDI=3, same CLK, LE and /OE
+        panels.add(&left)->add(&right);
+        left.set(0); right.set_word(1, 0xF00F); // their framebuffers, as usual
+        panels.flush(); // both switch on the same edge
+
+    flush() shifts every member's framebuffer at once: each clock writes every SDI, then one CLK edge,
+    so the whole group takes as long as the longest chain (not the sum). Shorter chains get padding first,
+    which falls off their end. Then one latch: a shared LE is pulsed once, separate LE's are raised together.
+    Every chain on that CLK has to be in the group (the clock shifts them all).
+    SPI members are bit-banged here (their SDI is MOSI).
+    The members' stats() count it (TLC5926_STATS): every clock of the pass, padding too, and the latch.
+*/
+
+#include <TLC5926.h>
+
+class TLC5926Group {
+    private:
+        TLC5926 *members[8];
+        TLC5926Pin sdi_io[8];
+        byte member_ct;
+        int CLK;
+        TLC5926Pin clk_io;
+        int le_pins[8], ioe_pins[8]; // distinct ones
+        TLC5926Pin le_io[8], ioe_io[8];
+        byte le_ct, ioe_ct;
+        static byte add_pin(int pin, int *pins, TLC5926Pin *io, byte ct);
+
+    public:
+        TLC5926Group();
+        TLC5926Group* add(TLC5926 *member); // up to 8, all with the same CLK
+        int size();
+        boolean dirty(); // any member
+        TLC5926Group* flush(); // all, if any changed
+        TLC5926Group* latch_pulse();
+        TLC5926Group* on();
+        TLC5926Group* off();
+    };
+
+#endif
@@ -0,0 +1,188 @@
+#include <TLC5926Matrix.h>
+#include <TLC5926Timer.h>
+
+TLC5926Matrix *TLC5926Matrix::running = NULL;
+
+TLC5926Matrix::TLC5926Matrix() {
+    tlc = NULL;
+    row_io = NULL;
+    rows = planes = 0;
+    row_on = HIGH;
+    bytes = 0;
+    slots = NULL;
+    slot = 0;
+    base_us = 0;
+    timed = false;
+    frame_ct = 0;
+    counting_since = 0;
+    last_isr_us = max_isr_us = 0;
+    }
+
+TLC5926Matrix* TLC5926Matrix::attach(TLC5926 *t, const int *row_pins, byte row_ct, byte plane_ct, int on_level) {
+    if (slots) return this; // already
+    if (!row_ct || plane_ct < 1 || plane_ct > 8) return this;
+    bytes = t->frame_bytes();
+    slots = (byte*) calloc((unsigned long)row_ct * plane_ct * bytes, 1);
+    row_io = (TLC5926Pin*) calloc(row_ct, sizeof(TLC5926Pin));
+    if (!slots || !row_io) { // no memory
+        free(slots);
+        free(row_io);
+        slots = NULL;
+        row_io = NULL;
+        return this;
+        }
+
+    tlc = t;
+    rows = row_ct;
+    planes = plane_ct;
+    row_on = on_level;
+    ioe_io.bind(tlc->iOE_pin());
+    for (int r = 0; r < rows; r++) {
+        row_io[r].bind(row_pins[r]);
+        pinMode(row_pins[r], OUTPUT);
+        row_io[r].write(!row_on);
+        }
+    return this;
+    }
+
+int TLC5926Matrix::columns() {
+    return tlc ? tlc->channels() : 0;
+    }
+
+TLC5926Matrix* TLC5926Matrix::set(int row, int column, byte value) {
+    if (!tlc || row < 0 || row >= rows || column < 0 || column >= columns()) return this;
+
+    // same layout as TLC5926::frame(), once per plane
+    byte *at = slots + (unsigned long)row * planes * bytes + bytes - 1 - (column >> 3);
+    byte mask = 1 << (column & 7);
+    for (int p = 0; p < planes; p++, at += bytes) {
+        if (value & (1 << p)) *at |= mask;
+        else *at &= ~mask;
+        }
+    return this;
+    }
+
+TLC5926Matrix* TLC5926Matrix::clear(int row, int column) {
+    return set(row, column, 0);
+    }
+
+byte TLC5926Matrix::get(int row, int column) {
+    if (!tlc || row < 0 || row >= rows || column < 0 || column >= columns()) return 0;
+
+    const byte *at = slots + (unsigned long)row * planes * bytes + bytes - 1 - (column >> 3);
+    byte mask = 1 << (column & 7);
+    byte value = 0;
+    for (int p = 0; p < planes; p++, at += bytes) {
+        if (*at & mask) value |= 1 << p;
+        }
+    return value;
+    }
+
+TLC5926Matrix* TLC5926Matrix::fill(byte value) {
+    if (!tlc) return this;
+    for (int r = 0; r < rows; r++) {
+        for (int p = 0; p < planes; p++) {
+            memset(slots + ((unsigned long)r * planes + p) * bytes, (value & (1 << p)) ? 0xFF : 0, bytes);
+            }
+        }
+    return this;
+    }
+
+boolean TLC5926Matrix::begin(unsigned int refresh_hz) {
+    if (!tlc || tlc->LE_pin() == -1 || tlc->iOE_pin() == -1 || !refresh_hz) return false;
+    end();
+
+    // slot 0 is shifted now, and latched at the first interrupt
+    unsigned long start = micros();
+    tlc->shift_bytes(slots, bytes);
+    unsigned long shift_us = micros() - start;
+    tlc->isr_ready();
+
+    // a whole scan is rows * (1 + 2 + .. + 2^(planes-1)) base slots
+    unsigned long base = 1000000UL / ((unsigned long)refresh_hz * rows * ((1 << planes) - 1));
+    if (base < shift_us + 8) return false; // too fast for the shift: fewer planes, lower rate, or SPI
+    if ((base << (planes - 1)) > 32000) return false; // too slow for the timer
+    base_us = base;
+
+    slot = slot_ct() - 1; // so the first interrupt goes to slot 0
+    ioe_io.high();
+    reset_counters();
+    running = this;
+    timed = TLC5926Timer::start(timer_isr, TLC5926Timer::us_to_ticks(base_us));
+    return timed;
+    }
+
+void TLC5926Matrix::end() {
+    if (running == this) {
+        if (timed) TLC5926Timer::stop();
+        running = NULL;
+        timed = false;
+        }
+    if (tlc) {
+        ioe_io.high();
+        row_io[slot / planes].write(!row_on);
+        }
+    }
+
+void TLC5926Matrix::timer_isr() {
+    if (running) running->isr();
+    }
+
+unsigned int TLC5926Matrix::isr() {
+    unsigned long start = micros();
+
+    // blank, so the old columns don't show on the new row (or the new ones on the old)
+    ioe_io.high();
+    row_io[slot / planes].write(!row_on);
+    tlc->isr_latch();
+    slot = slot + 1 == slot_ct() ? 0 : slot + 1;
+    row_io[slot / planes].write(row_on);
+    ioe_io.low();
+
+    unsigned int slot_us = base_us << (slot % planes);
+    if (timed) TLC5926Timer::next(TLC5926Timer::us_to_ticks(slot_us));
+    if (slot == 0) frame_ct++;
+
+    // and the next slot's columns, while this one shows
+    int next = slot + 1 == slot_ct() ? 0 : slot + 1;
+    tlc->isr_shift(slots + (unsigned long)next * bytes, bytes);
+
+    last_isr_us = micros() - start;
+    if (last_isr_us > max_isr_us) max_isr_us = last_isr_us;
+    return slot_us;
+    }
+
+unsigned long TLC5926Matrix::frames() {
+    noInterrupts();
+    unsigned long ct = frame_ct;
+    interrupts();
+    return ct;
+    }
+
+unsigned int TLC5926Matrix::fps() {
+    unsigned long ms = millis() - counting_since;
+    return ms ? frames() * 1000UL / ms : 0;
+    }
+
+unsigned int TLC5926Matrix::isr_us() {
+    noInterrupts();
+    unsigned int us = last_isr_us;
+    interrupts();
+    return us;
+    }
+
+unsigned int TLC5926Matrix::isr_max_us() {
+    noInterrupts();
+    unsigned int us = max_isr_us;
+    interrupts();
+    return us;
+    }
+
+TLC5926Matrix* TLC5926Matrix::reset_counters() {
+    noInterrupts();
+    frame_ct = 0;
+    last_isr_us = max_isr_us = 0;
+    interrupts();
+    counting_since = millis();
+    return this;
+    }
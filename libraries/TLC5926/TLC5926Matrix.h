@@ -0,0 +1,71 @@
+#ifndef TLC5926Matrix_h
+#define TLC5926Matrix_h
+
+/*
+    A multiplexed LED matrix: the TLC5926 chain drives the columns, a pin per row switches the row (transistor),
+    scanned in the background.
+
+        const int row_pins[] = { 4, 5, 6, 7, 8, 14, 15, 16 };
+        TLC5926 tlc;
+        TLC5926Matrix matrix;
+
+        tlc.attach(2, SDI_pin, CLK_pin, LE_pin, iOE_pin); // 32 columns. Needs LE and iOE
+        matrix.attach(&tlc, row_pins, 8); // 8 rows, on/off pixels
+        matrix.set(0, 0)->set(7, 31);
+        matrix.begin(120); // each row 120 times a second
+
+    With planes > 1 (attach(&tlc, row_pins, 8, 4)), each pixel is 0..(2^planes - 1), by binary code modulation
+    like TLC5926BCM: each row is shown once per plane, for (base << plane).
+    Each interrupt: iOE off, row off, latch the columns shifted last time, next row on, iOE on, then shift the
+    columns for the next slot while this one shows. So the shortest slot has to be longer than a shift:
+    begin() fails if the refresh rate can't be done (try fewer planes, a lower rate, or attach_spi()).
+
+    frames() counts whole scans, fps() is frames per second since reset_counters() (or begin()),
+    isr_us()/isr_max_us() are how long the interrupt took.
+
+    Uses TLC5926Timer: #include <TLC5926TimerISR.h> in the sketch. Without it (or not on AVR): begin() returns
+    false, call isr() from your own timer,
+    it returns the us until the next call.
+*/
+
+#include <TLC5926.h>
+
+class TLC5926Matrix {
+    private:
+        TLC5926 *tlc;
+        TLC5926Pin *row_io;
+        TLC5926Pin ioe_io;
+        byte rows, planes;
+        int row_on; // HIGH or LOW turns a row on
+        int bytes; // per row+plane, frame_bytes()
+        byte *slots; // rows x planes x bytes, row 0 plane 0 first, each like TLC5926::frame()
+        volatile int slot; // showing now
+        unsigned int base_us;
+        boolean timed;
+        volatile unsigned long frame_ct;
+        unsigned long counting_since;
+        volatile unsigned int last_isr_us, max_isr_us;
+        static TLC5926Matrix *running;
+        static void timer_isr();
+        int slot_ct() { return rows * planes; }
+
+    public:
+        TLC5926Matrix();
+        TLC5926Matrix* attach(TLC5926 *tlc, const int *row_pins, byte rows, byte planes = 1, int row_on = HIGH);
+        TLC5926Matrix* set(int row, int column, byte value = 1);
+        TLC5926Matrix* clear(int row, int column);
+        byte get(int row, int column);
+        TLC5926Matrix* fill(byte value);
+        int columns();
+        boolean begin(unsigned int refresh_hz = 100);
+        void end(); // blank
+        unsigned int isr();
+
+        unsigned long frames();
+        unsigned int fps();
+        unsigned int isr_us();
+        unsigned int isr_max_us();
+        TLC5926Matrix* reset_counters();
+    };
+
+#endif
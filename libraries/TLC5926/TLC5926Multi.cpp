@@ -0,0 +1,148 @@
+#include <TLC5926Multi.h>
+#include "pins_arduino.h"
+
+TLC5926Multi::TLC5926Multi() {
+    CLK = -1;
+    LE = -1;
+    iOE = -1;
+    ct = 0;
+    debugging = false;
+    for (int i=0; i<8; i++) lanes[i] = NULL;
+    sdi_port = -1;
+    sdi_mask = 0;
+#if TLC5926_PORT_IO
+    sdi_out = NULL;
+#endif
+    }
+
+TLC5926Multi* TLC5926Multi::debug(boolean v) { debugging = v; return this; }
+
+void TLC5926Multi::debug_print(const char *msg) {
+    Serial.print("[TLC5926Multi ");
+    Serial.print((uintptr_t)this);
+    Serial.print("] ");
+    Serial.println(msg);
+    }
+
+TLC5926Multi* TLC5926Multi::attach(int chained_ct, int clk_pin, int le_pin, int ioe_pin) {
+    if (ct) {
+        TLC5926_WARN("Warning, already attached.");
+        return this;
+        }
+
+    ct = chained_ct;
+    CLK = clk_pin;
+    LE = le_pin;
+    iOE = ioe_pin;
+    clk_io.bind(CLK);
+    le_io.bind(LE);
+    ioe_io.bind(iOE);
+
+    pinMode(CLK, OUTPUT);
+    clk_io.low();
+    if (LE != -1) {
+        pinMode(LE, OUTPUT);
+        le_io.low();
+        }
+    if (iOE != -1) {
+        pinMode(iOE, OUTPUT);
+        on();
+        }
+    return this;
+    }
+
+TLC5926Multi* TLC5926Multi::add_chain(int sdi_pin, const byte *frame) {
+    int lane;
+
+#if TLC5926_PORT_IO
+    int port = digitalPinToPort(sdi_pin);
+    if (sdi_port != -1 && port != sdi_port) {
+        TLC5926_WARN("Warning, add_chain() SDI isn't on the same port as the others");
+        return this;
+        }
+    sdi_port = port;
+    sdi_out = portOutputRegister(port);
+    byte mask = digitalPinToBitMask(sdi_pin);
+    for (lane = 0; !(mask & (1 << lane)); lane++) ;
+#else
+    for (lane = 0; lane < 8 && lanes[lane]; lane++) ;
+    if (lane == 8) {
+        TLC5926_WARN("Warning, add_chain() only 8 chains");
+        return this;
+        }
+#endif
+
+    lanes[lane] = frame;
+    lane_io[lane].bind(sdi_pin);
+    sdi_mask |= 1 << lane;
+    pinMode(sdi_pin, OUTPUT);
+    return this;
+    }
+
+int TLC5926Multi::frame_bytes() { return ct * 2; }
+
+void TLC5926Multi::transpose8(const byte in[8], byte out[8]) {
+    // Hacker's Delight transpose8 (32-bit halves, cheaper on an 8-bit cpu than a 64-bit word)
+    uint32_t x = ((uint32_t)in[7] << 24) | ((uint32_t)in[6] << 16) | ((uint32_t)in[5] << 8) | in[4];
+    uint32_t y = ((uint32_t)in[3] << 24) | ((uint32_t)in[2] << 16) | ((uint32_t)in[1] << 8) | in[0];
+    uint32_t t;
+
+    t = (x ^ (x >> 7)) & 0x00AA00AA; x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA; y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    out[0] = x >> 24; out[1] = x >> 16; out[2] = x >> 8; out[3] = x;
+    out[4] = y >> 24; out[5] = y >> 16; out[6] = y >> 8; out[7] = y;
+    }
+
+TLC5926Multi* TLC5926Multi::shift() {
+    byte in[8], out[8];
+
+    for (int i = 0; i < frame_bytes(); i++) {
+        for (int lane = 0; lane < 8; lane++) in[lane] = lanes[lane] ? lanes[lane][i] : 0;
+        transpose8(in, out);
+
+        for (int k = 0; k < 8; k++) {
+#if TLC5926_PORT_IO
+            uint8_t sreg = SREG;
+            cli();
+            *sdi_out = (*sdi_out & ~sdi_mask) | (out[k] & sdi_mask);
+            SREG = sreg;
+#else
+            for (int lane = 0; lane < 8; lane++) {
+                if (lanes[lane]) lane_io[lane].write(out[k] & (1 << lane));
+                }
+#endif
+            clk_io.pulse();
+            }
+        }
+    return this;
+    }
+
+TLC5926Multi* TLC5926Multi::send() {
+    shift();
+    if (LE != -1) latch_pulse();
+    return this;
+    }
+
+TLC5926Multi* TLC5926Multi::latch_pulse() {
+    if (LE != -1) le_io.pulse();
+    else TLC5926_WARN("Warning: latch_pulse() -- LE not specified");
+    return this;
+    }
+
+TLC5926Multi* TLC5926Multi::on() {
+    if (iOE != -1) ioe_io.low(); // inverted
+    else TLC5926_WARN("Warning: on() -- iOE not specified");
+    return this;
+    }
+
+TLC5926Multi* TLC5926Multi::off() {
+    if (iOE != -1) ioe_io.high(); // inverted
+    else TLC5926_WARN("Warning: off() -- iOE not specified");
+    return this;
+    }
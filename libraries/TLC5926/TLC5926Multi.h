@@ -0,0 +1,62 @@
+#ifndef TLC5926Multi_h
+#define TLC5926Multi_h
+
+/*
+    Up to 8 chains of TLC5926's, clocked together.
+
+    All the chains share CLK, LE and /OE. Each chain has its own SDI, and (on AVR, TLC5926_PORT_IO) all the SDI's
+    must be on the same port (e.g. 0-7 on an Uno is PORTD, but avoid 0/1 if you use Serial).
+    Every clock edge writes all the SDI's in one port write, so 8 chains cost the same as 1.
+
+        const int CHAIN_CT = 4;
+        byte left[2 * CHAIN_CT], right[2 * CHAIN_CT]; // same layout as TLC5926::frame()
+        TLC5926Multi chains;
+
+        chains.attach(CHAIN_CT, 8, 9, 10) // CLK, LE, /OE
+            ->add_chain(4, left) // SDI pins
+            ->add_chain(5, right);
+        ...
+        left[0] = 0xFF; right[3] = 0x81;
+        chains.send(); // shift all of them, one latch
+*/
+
+#include <TLC5926.h>
+
+class TLC5926Multi {
+    private:
+        int CLK;
+        int LE;
+        int iOE;
+        int ct;
+        boolean debugging;
+        TLC5926Pin clk_io, le_io, ioe_io;
+        // per "lane": on AVR a lane is the SDI's bit in the port, otherwise in order of add_chain()
+        const byte *lanes[8];
+        TLC5926Pin lane_io[8];
+        int sdi_port;
+        byte sdi_mask;
+#if TLC5926_PORT_IO
+        TLC5926_PORT_REG *sdi_out;
+#endif
+
+        void debug_print(const char *msg);
+
+    public:
+        TLC5926Multi();
+        TLC5926Multi* debug(boolean v);
+        TLC5926Multi* attach(int chained_ct, int clk_pin, int le_pin = -1, int ioe_pin = -1);
+        // frame is 2 * chained_ct bytes, in shift order like TLC5926::frame(). Not copied.
+        TLC5926Multi* add_chain(int sdi_pin, const byte *frame);
+        int frame_bytes();
+        TLC5926Multi* shift(); // all chains, no latch
+        TLC5926Multi* send(); // shift + latch
+        TLC5926Multi* latch_pulse();
+        TLC5926Multi* on();
+        TLC5926Multi* off();
+
+        // 8x8 bit transpose: bit b of out[k] = bit (7-k) of in[b].
+        // i.e. in[] is one byte per lane, out[] is the port values for each clock, MSB first.
+        static void transpose8(const byte in[8], byte out[8]);
+    };
+
+#endif
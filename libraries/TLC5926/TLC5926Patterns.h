@@ -0,0 +1,135 @@
+#ifndef TLC5926Patterns_h
+#define TLC5926Patterns_h
+
+/*
+    Frame tables built at compile time, into PROGMEM: playing them back is just a table walk.
+
+        #include <TLC5926Patterns.h>
+
+        typedef TLC5926Bounce<32> bounce; // 2 chips wide
+        typedef TLC5926Mirror<TLC5926Fill<32> > fill_from_the_end;
+        typedef TLC5926Reversed<TLC5926Chase<32> > chase_on_backwards_wiring; // OUT15..OUT0 per chip
+
+        for (unsigned f = 0; f < bounce::frames; f++) {
+            TLC5926Table<bounce>::show(&tlc, f); // set_bytes() + flush()
+            delay(50);
+            }
+        // or, the bytes: TLC5926Table<bounce>::data, frame f at f * TLC5926Table<bounce>::bytes (frame() order)
+
+    A pattern is a type with channels, frames, and a constexpr on(frame, channel). Channel 0 is OUT0 of the
+    first chip, like TLC5926::set(). The ones here:
+        TLC5926Chase<N>       one channel on, 0 to N-1
+        TLC5926Bounce<N>      one channel on, 0 to N-1 and back (2N-2 frames)
+        TLC5926Fill<N>        none on, then 0, then 0-1, ... all (N+1 frames)
+        TLC5926Mirror<P>      P end-to-end
+        TLC5926Reversed<P,W>  P with each W-channel chip wired backwards (default 16)
+        TLC5926Remapped<P,M>  P with any channel order: M::logical(physical) says which of P's channels
+                              physical channel shows, e.g.
+                                  struct Snake { static constexpr unsigned logical(unsigned c) { return (c / 8) % 2 ? c ^ 7 : c; } };
+    Make your own the same way. Each table is channels/8 * frames bytes of flash, no RAM.
+    C++11 (what the Arduino IDE uses): constexpr functions are one return statement, so no loops.
+*/
+
+#include <TLC5926.h>
+
+template <unsigned N>
+struct TLC5926Chase {
+    static const unsigned channels = N;
+    static const unsigned frames = N;
+    static constexpr bool on(unsigned frame, unsigned channel) { return channel == frame; }
+    };
+
+template <unsigned N>
+struct TLC5926Bounce {
+    static const unsigned channels = N;
+    static const unsigned frames = N > 1 ? 2 * N - 2 : 1;
+    static constexpr bool on(unsigned frame, unsigned channel) {
+        return channel == (frame < N ? frame : 2 * N - 2 - frame);
+        }
+    };
+
+template <unsigned N>
+struct TLC5926Fill {
+    static const unsigned channels = N;
+    static const unsigned frames = N + 1;
+    static constexpr bool on(unsigned frame, unsigned channel) { return channel < frame; }
+    };
+
+template <class P>
+struct TLC5926Mirror {
+    static const unsigned channels = P::channels;
+    static const unsigned frames = P::frames;
+    static constexpr bool on(unsigned frame, unsigned channel) { return P::on(frame, channels - 1 - channel); }
+    };
+
+template <class P, unsigned W = 16>
+struct TLC5926Reversed {
+    static const unsigned channels = P::channels;
+    static const unsigned frames = P::frames;
+    static constexpr bool on(unsigned frame, unsigned channel) {
+        return P::on(frame, channel - channel % W + (W - 1 - channel % W));
+        }
+    };
+
+template <class P, class M>
+struct TLC5926Remapped {
+    static const unsigned channels = P::channels;
+    static const unsigned frames = P::frames;
+    static constexpr bool on(unsigned frame, unsigned channel) { return P::on(frame, M::logical(channel)); }
+    };
+
+// 0..N-1 as a parameter pack, in log(N) template depth (so big tables don't hit the recursion limit)
+template <unsigned... I> struct TLC5926Indices { };
+
+template <class A, class B> struct TLC5926JoinIndices;
+template <unsigned... A, unsigned... B>
+struct TLC5926JoinIndices<TLC5926Indices<A...>, TLC5926Indices<B...> > {
+    typedef TLC5926Indices<A..., (sizeof...(A) + B)...> type;
+    };
+
+template <unsigned N>
+struct TLC5926MakeIndices {
+    typedef typename TLC5926JoinIndices<
+        typename TLC5926MakeIndices<N / 2>::type, typename TLC5926MakeIndices<N - N / 2>::type
+        >::type type;
+    };
+template <> struct TLC5926MakeIndices<0> { typedef TLC5926Indices<> type; };
+template <> struct TLC5926MakeIndices<1> { typedef TLC5926Indices<0> type; };
+
+// the byte of frame f with channels base..base+7 (frame() order: byte 0 has the highest 8 channels)
+template <class P>
+constexpr byte tlc5926_frame_byte(unsigned f, unsigned base) {
+    return P::on(f, base) | P::on(f, base + 1) << 1 | P::on(f, base + 2) << 2 | P::on(f, base + 3) << 3
+        | P::on(f, base + 4) << 4 | P::on(f, base + 5) << 5 | P::on(f, base + 6) << 6 | P::on(f, base + 7) << 7;
+    }
+
+template <class P, class I> struct TLC5926TableData;
+template <class P, unsigned... I>
+struct TLC5926TableData<P, TLC5926Indices<I...> > {
+    static const unsigned bytes = P::channels / 8;
+    static const byte data[sizeof...(I)];
+    };
+template <class P, unsigned... I>
+const byte TLC5926TableData<P, TLC5926Indices<I...> >::data[sizeof...(I)] PROGMEM = {
+    tlc5926_frame_byte<P>(I / (P::channels / 8), (P::channels / 8 - 1 - I % (P::channels / 8)) * 8)...
+    };
+
+template <class P>
+struct TLC5926Table : TLC5926TableData<P, typename TLC5926MakeIndices<P::frames * (P::channels / 8)>::type> {
+    static_assert(P::channels % 8 == 0 && P::channels, "TLC5926Table: channels has to be a multiple of 8");
+    static const unsigned frames = P::frames;
+    static const unsigned channels = P::channels;
+
+    // into the framebuffer (only the bytes that changed), and flush(). A narrower pattern is the first channels
+    static void show(TLC5926 *tlc, unsigned frame) {
+        const byte *at = TLC5926Table::data + frame * TLC5926Table::bytes;
+        int offset = tlc->frame_bytes() - TLC5926Table::bytes;
+        for (unsigned i = 0; i < TLC5926Table::bytes; i++) {
+            byte b = pgm_read_byte(at + i);
+            tlc->set_bytes(offset + i, &b, 1);
+            }
+        tlc->flush();
+        }
+    };
+
+#endif
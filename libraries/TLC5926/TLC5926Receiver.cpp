@@ -0,0 +1,107 @@
+#include <TLC5926Receiver.h>
+
+TLC5926Receiver::TLC5926Receiver() {
+    tlc = NULL;
+    in = NULL;
+    state = SYNC1;
+    length = at = 0;
+    sum = 0;
+    chip = 0;
+    held_ct = 0;
+    good_ct = bad_ct = 0;
+    }
+
+TLC5926Receiver* TLC5926Receiver::attach(TLC5926 *t, Stream &s) {
+    tlc = t;
+    in = &s;
+    state = SYNC1;
+    return this;
+    }
+
+boolean TLC5926Receiver::poll() {
+    boolean latched = false;
+    if (!in) return false;
+    while (in->available() > 0) {
+        int b = in->read();
+        if (b < 0) break;
+        if (feed(b)) latched = true;
+        }
+    return latched;
+    }
+
+boolean TLC5926Receiver::feed(byte b) {
+    if (!tlc) return false;
+
+    switch (state) {
+        case SYNC1:
+            if (b == TLC5926_RX_SYNC1) state = SYNC2;
+            break;
+
+        case SYNC2:
+            state = b == TLC5926_RX_SYNC2 ? LENGTH_LO : b == TLC5926_RX_SYNC1 ? SYNC2 : SYNC1;
+            break;
+
+        case LENGTH_LO:
+            length = b;
+            sum = b;
+            state = LENGTH_HI;
+            break;
+
+        case LENGTH_HI:
+            length |= (unsigned int)b << 8;
+            sum += b;
+            at = 0;
+            chip = tlc->chips() - 1;
+            held_ct = 0;
+            if (length != (unsigned int)tlc->frame_bytes() || (tlc->LE_pin() == -1 && !tlc->frame())) {
+                bad_ct++;
+                state = SYNC1;
+                }
+            else state = PAYLOAD;
+            break;
+
+        case PAYLOAD:
+            sum += b;
+            // straight into the chain, it doesn't show until the latch. No LE: hold it in the framebuffer
+            if (tlc->LE_pin() != -1) shift_mapped(b);
+            else tlc->set_bytes(at, &b, 1);
+            if (++at == length) state = CHECKSUM;
+            break;
+
+        case CHECKSUM:
+            state = SYNC1;
+            if ((byte)(sum + b) != 0) {
+                bad_ct++;
+                return false;
+                }
+            if (tlc->LE_pin() != -1) tlc->latch_pulse();
+            else tlc->flush();
+            good_ct++;
+            return true;
+        }
+    return false;
+    }
+
+void TLC5926Receiver::shift_mapped(byte b) {
+    // a byte of the frame: as is, or with a channel_map(), once the chip's word is in
+    if (!tlc->remap) {
+        tlc->shift_bytes(&b, 1);
+        return;
+        }
+    held[held_ct++] = b;
+    if (held_ct * 8 < tlc->chip_width(chip)) return;
+    tlc->begin_shift();
+    if (held_ct == 2) {
+        unsigned int physical = tlc->to_physical(held[0] << 8 | held[1], chip);
+        tlc->shift_byte(physical >> 8);
+        tlc->shift_byte(physical);
+        }
+    else tlc->shift_byte(tlc->to_physical(held[0], chip));
+    tlc->end_shift();
+    held_ct = 0;
+    chip--;
+    }
+
+unsigned long TLC5926Receiver::frames() { return good_ct; }
+
+unsigned long TLC5926Receiver::errors() { return bad_ct; }
@@ -0,0 +1,59 @@
+#ifndef TLC5926Receiver_h
+#define TLC5926Receiver_h
+
+/*
+    Frames from a host (Serial, or any Stream), straight into the chain.
+
+        TLC5926 tlc;
+        TLC5926Receiver rx;
+
+        Serial.begin(115200);
+        tlc.attach(4, SDI_pin, CLK_pin, LE_pin, iOE_pin);
+        rx.attach(&tlc, Serial);
+        ...
+        rx.poll(); // in loop(): whatever has arrived, doesn't wait
+
+    Protocol (extras/send_frames.py does the host side):
+        0xA5 0x5A           sync
+        length              2 bytes, little-endian: has to be frame_bytes()
+        payload             length bytes, same order as TLC5926::frame()
+        checksum            1 byte: length + payload + checksum adds up to 0 (mod 256)
+
+    Frames are in TLC5926::frame() order, channel_map() and all: the same frame shows the same either way.
+    With LE, each payload byte is shifted into the chain as it arrives (nothing is buffered; with a channel_map(),
+    a chip's bytes are held until its word is in), and latched only if the checksum is good: a bad frame never shows,
+    the last good one stays up.
+    Like send(), that marks the framebuffer changed, so the next flush() puts it back up.
+    Without LE every shift would show, so the payload goes into the framebuffer instead, and is flush()'d if good
+    (a bad one is left half-written in the framebuffer, but not shown).
+*/
+
+#include <TLC5926.h>
+
+#define TLC5926_RX_SYNC1 0xA5
+#define TLC5926_RX_SYNC2 0x5A
+
+class TLC5926Receiver {
+    private:
+        TLC5926 *tlc;
+        Stream *in;
+        enum { SYNC1, SYNC2, LENGTH_LO, LENGTH_HI, PAYLOAD, CHECKSUM } state;
+        unsigned int length;
+        unsigned int at;
+        byte sum;
+        int chip; // whose bytes are coming in, last chip first
+        byte held[2]; // its bytes so far, for the channel map
+        byte held_ct;
+        void shift_mapped(byte b);
+        unsigned long good_ct, bad_ct;
+
+    public:
+        TLC5926Receiver();
+        TLC5926Receiver* attach(TLC5926 *tlc, Stream &in);
+        boolean poll(); // true if a frame went up
+        boolean feed(byte b); // one byte, e.g. from your own buffer. true if it finished a good frame
+        unsigned long frames(); // good ones
+        unsigned long errors(); // bad checksum or length
+    };
+
+#endif
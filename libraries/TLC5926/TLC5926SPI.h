@@ -0,0 +1,37 @@
+#ifndef TLC5926SPI_h
+#define TLC5926SPI_h
+
+/*
+    The hardware SPI transport for TLC5926::attach_spi(). Only this header uses SPI.h, so a sketch that just
+    bit-bangs doesn't need the SPI library. Include it in the sketch (once is enough), it registers itself:
+
+        #include <TLC5926SPI.h>
+        #include <TLC5926.h>
+        ...
+        tlc.attach_spi(24, LE_pin, iOE_pin);
+
+    Without it, attach_spi() warns and bit-bangs MOSI/SCK.
+*/
+
+#include <SPI.h>
+#include <TLC5926.h>
+
+class TLC5926SPI {
+    private:
+        static void begin() { SPI.begin(); }
+        static void end() { SPI.end(); }
+        static void begin_transaction(unsigned long clock) { SPI.beginTransaction(SPISettings(clock, MSBFIRST, SPI_MODE0)); }
+        static byte transfer(byte b) { return SPI.transfer(b); }
+        static void end_transaction() { SPI.endTransaction(); }
+
+    public:
+        static const TLC5926Bus *bus() {
+            static const TLC5926Bus spi = { begin, end, begin_transaction, transfer, end_transaction };
+            return &spi;
+            }
+        TLC5926SPI() { TLC5926::spi_transport(bus()); }
+    };
+
+static TLC5926SPI tlc5926_spi; // before setup()
+
+#endif
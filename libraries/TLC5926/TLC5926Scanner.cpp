@@ -0,0 +1,111 @@
+#include <TLC5926Scanner.h>
+#include <TLC5926Timer.h>
+
+TLC5926Scanner *TLC5926Scanner::running = NULL;
+
+TLC5926Scanner::TLC5926Scanner() {
+    tlc = NULL;
+    ct = 0;
+    words = sample = debounced = cnt0 = cnt1 = NULL;
+    changed = NULL;
+    timed = false;
+    }
+
+TLC5926Scanner* TLC5926Scanner::attach(TLC5926 *t) {
+    if (words) return this; // already
+    ct = t->chips();
+    words = (unsigned int*) calloc(5 * ct, sizeof(unsigned int));
+    if (!words) return this;
+    tlc = t;
+    sample = words;
+    debounced = words + ct;
+    cnt0 = words + 2 * ct;
+    cnt1 = words + 3 * ct;
+    changed = words + 4 * ct;
+    return this;
+    }
+
+boolean TLC5926Scanner::begin(unsigned int period_us) {
+    if (!tlc) return false;
+    end();
+    if (!tlc->detect_hold()) return false;
+
+    // start from what's there now, not "everything changed"
+    tlc->detect_sample(debounced, ct);
+    for (int i = 0; i < ct; i++) cnt0[i] = cnt1[i] = changed[i] = 0;
+
+    running = this;
+    timed = TLC5926Timer::start(timer_isr, TLC5926Timer::us_to_ticks(period_us));
+    return timed;
+    }
+
+void TLC5926Scanner::end() {
+    if (running == this) {
+        if (timed) TLC5926Timer::stop();
+        running = NULL;
+        timed = false;
+        }
+    if (tlc) tlc->detect_release();
+    }
+
+void TLC5926Scanner::timer_isr() {
+    if (running) running->isr();
+    }
+
+void TLC5926Scanner::isr() {
+    if (!tlc->isr_detect(sample, ct)) return;
+
+    // vertical counters: each bit of cnt1:cnt0 counts samples that differ from debounced,
+    // and resets when they agree. A bit flips when its count wraps (4 in a row).
+    for (int i = 0; i < ct; i++) {
+        unsigned int delta = sample[i] ^ debounced[i];
+        cnt1[i] = (cnt1[i] ^ cnt0[i]) & delta;
+        cnt0[i] = ~cnt0[i] & delta;
+        unsigned int flip = delta & ~(cnt0[i] | cnt1[i]);
+        debounced[i] ^= flip;
+        changed[i] |= flip;
+        }
+    }
+
+int TLC5926Scanner::get(int channel) {
+    if (!tlc || channel < 0 || channel >= tlc->channels()) return 0;
+    int chip = 0;
+    while (channel >= tlc->chip_channel(chip) + tlc->chip_width(chip)) chip++;
+    return bitRead(state(chip), channel - tlc->chip_channel(chip));
+    }
+
+unsigned int TLC5926Scanner::state(int chip) {
+    if (!tlc || chip < 0 || chip >= ct) return 0;
+    noInterrupts();
+    unsigned int s = debounced[chip];
+    interrupts();
+    return s;
+    }
+
+unsigned int TLC5926Scanner::changes(int chip) {
+    if (!tlc || chip < 0 || chip >= ct) return 0;
+    noInterrupts();
+    unsigned int c = changed[chip];
+    changed[chip] = 0;
+    interrupts();
+    return c;
+    }
+
+int TLC5926Scanner::next_change() {
+    for (int chip = 0; tlc && chip < ct; chip++) {
+        noInterrupts();
+        unsigned int c = changed[chip];
+        unsigned int lowest = c & -c;
+        changed[chip] = c & ~lowest;
+        interrupts();
+        if (!lowest) continue;
+
+        int bit = 0;
+        while (!(lowest & 1)) {
+            lowest >>= 1;
+            bit++;
+            }
+        return tlc->chip_channel(chip) + bit;
+        }
+    return -1;
+    }
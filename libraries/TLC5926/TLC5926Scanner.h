@@ -0,0 +1,53 @@
+#ifndef TLC5926Scanner_h
+#define TLC5926Scanner_h
+
+/*
+    The outputs as debounced digital inputs (see "Stupid Tricks"), sampled in the background.
+
+        TLC5926 tlc;
+        TLC5926Scanner inputs;
+
+        tlc.attach(2, SDI_pin, CLK_pin, LE_pin, iOE_pin, SDO_pin); // needs LE, iOE and SDO
+        inputs.attach(&tlc)->begin(1000); // sample every 1000us
+
+        int ch;
+        while ((ch = inputs.next_change()) != -1) {
+            Serial.print(ch); Serial.println(inputs.get(ch) ? " closed" : " open");
+            }
+
+    The chain stays in error-detect mode (TLC5926::detect_hold()), so each sample is just the
+    "iOE low, clock out every chip's bits" part, on TLC5926Timer. A channel is 1 if current flows (switch closed).
+    Debounced by 2-bit vertical counters: 16 channels at a time, a change has to hold for 4 samples.
+    Don't use the TLC5926 for anything else until end().
+
+    The timer needs #include <TLC5926TimerISR.h> in the sketch. Without it (or not on AVR): begin() returns false,
+    call isr() from your own timer.
+*/
+
+#include <TLC5926.h>
+
+class TLC5926Scanner {
+    private:
+        TLC5926 *tlc;
+        int ct; // chips
+        unsigned int *words; // 5 x ct: sample, state, cnt0, cnt1, changed
+        unsigned int *sample, *debounced, *cnt0, *cnt1;
+        volatile unsigned int *changed;
+        boolean timed;
+        static TLC5926Scanner *running;
+        static void timer_isr();
+
+    public:
+        TLC5926Scanner();
+        TLC5926Scanner* attach(TLC5926 *tlc);
+        boolean begin(unsigned int period_us = 1000);
+        void end(); // back to normal mode
+        void isr(); // one sample
+
+        int get(int channel); // debounced
+        unsigned int state(int chip); // bitmap, bit n is OUTn
+        unsigned int changes(int chip); // changed since the last call (or next_change())
+        int next_change(); // a channel that changed, and clears it. -1 if none
+    };
+
+#endif
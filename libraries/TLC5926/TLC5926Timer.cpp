@@ -0,0 +1,77 @@
+#include <TLC5926Timer.h>
+#include <TLC5926.h>
+
+#if defined(__AVR__) && defined(TIMSK1)
+#define TLC5926_HAS_TIMER 1
+#include <avr/interrupt.h>
+#endif
+
+void (* volatile TLC5926Timer::compare_isr)() = NULL;
+void (* volatile TLC5926Timer::overflow_isr)() = NULL;
+static boolean timer_claimed = false;
+static boolean timer_running = false; // start()'d, not stop()'d
+static boolean timer_reserved = false;
+
+unsigned int TLC5926Timer::us_to_ticks(unsigned long us) {
+    unsigned long ticks = us * (F_CPU / 1000000L) / 8;
+    return ticks > 65535 ? 65535 : ticks;
+    }
+
+static boolean async_start(void (*isr)(), unsigned int period_us) {
+    return TLC5926Timer::start(isr, TLC5926Timer::us_to_ticks(period_us));
+    }
+
+void TLC5926Timer::claim() {
+    timer_claimed = true;
+    TLC5926::async_timer(async_start, stop); // so the core doesn't need us otherwise
+    }
+
+boolean TLC5926Timer::claimed() { return timer_claimed; }
+
+boolean TLC5926Timer::reserve() {
+    if (timer_running) return false;
+    timer_reserved = true;
+    return true;
+    }
+
+boolean TLC5926Timer::reserved() { return timer_reserved; }
+
+#ifdef TLC5926_HAS_TIMER
+
+boolean TLC5926Timer::start(void (*isr)(), unsigned int ticks) {
+    if (!timer_claimed) return false; // no vector, see TLC5926TimerISR.h
+    if (timer_reserved) return false; // the Dimmer's pwm setup
+    uint8_t sreg = SREG;
+    cli();
+    compare_isr = isr;
+    TCCR1A = 0;
+    TCCR1B = _BV(WGM12) | _BV(CS11); // CTC on OCR1A, clk/8
+    TCNT1 = 0;
+    OCR1A = ticks;
+    TIFR1 = _BV(OCF1A); // nothing pending
+    TIMSK1 |= _BV(OCIE1A);
+    timer_running = true;
+    SREG = sreg;
+    return true;
+    }
+
+void TLC5926Timer::next(unsigned int ticks) {
+    // TCNT1 was just reset by the match, so this is the period we are in now
+    OCR1A = ticks;
+    }
+
+void TLC5926Timer::stop() {
+    if (!timer_running) return; // never started, or it isn't ours
+    TIMSK1 &= ~_BV(OCIE1A);
+    TCCR1B = 0;
+    compare_isr = NULL;
+    timer_running = false;
+    }
+
+#else
+
+boolean TLC5926Timer::start(void (*)(), unsigned int) { return false; }
+void TLC5926Timer::next(unsigned int) { }
+void TLC5926Timer::stop() { }
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TLC5926Timer_h
+#define TLC5926Timer_h
+
+/*
+    The timer interrupt for the background engines (TLC5926BCM, etc.).
+
+    Uses Timer1's compare-match-A interrupt (AVR w/Timer1: Uno, Mega, Leonardo...),
+    so only one engine can run at a time, and it conflicts with Servo and analogWrite() on pins 9/10 (Uno).
+    The period is in "ticks" of F_CPU/8 (0.5us at 16MHz), max 65535.
+
+    The interrupt vectors are only linked in if the sketch includes TLC5926TimerISR.h (see there),
+    so the library leaves Timer1 to Servo, etc. otherwise.
+    Without it (or not on AVR), start() returns false: call the engine's isr() from your own timer instead.
+
+    start() rewrites Timer1's whole setup, so it also returns false once TLC5926Dimmer has Timer1 for 12-bit pwm
+    (see reserve()), and the Dimmer can't have it while an engine is running.
+*/
+
+#include <Arduino.h>
+
+class TLC5926Timer {
+    public:
+        static boolean start(void (*isr)(), unsigned int ticks);
+        static void next(unsigned int ticks); // period after the current one, call from the isr
+        static void stop();
+        static unsigned int us_to_ticks(unsigned long us); // clamps at 65535
+
+        // Timer1 for something else (TLC5926Dimmer's 12-bit pwm): false if start()'d, else start() is refused from now on
+        static boolean reserve();
+        static boolean reserved();
+
+        // for TLC5926TimerISR.h
+        static void claim(); // the vectors are linked in: start() can use the timer
+        static boolean claimed();
+        static void (* volatile compare_isr)();
+        static void (* volatile overflow_isr)(); // TLC5926Dimmer's 12-bit fades
+    };
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef TLC5926TimerISR_h
+#define TLC5926TimerISR_h
+
+/*
+    Timer1's interrupt vectors for TLC5926Timer: TLC5926BCM, TLC5926Matrix, TLC5926Scanner, TLC5926Dimmer's dither
+    and 12-bit fades, and TLC5926::send_async()/flush_async(). Include it in one file of the sketch:
+
+        #include <TLC5926TimerISR.h>
+        #include <TLC5926BCM.h>
+
+    It defines ISR(TIMER1_COMPA_vect) and ISR(TIMER1_OVF_vect), so they're only linked in if you ask for them:
+    without it, Servo (etc.) can have Timer1, and TLC5926Timer::start() returns false, as it does elsewhere.
+    Twice is a duplicate vector.
+*/
+
+#include <TLC5926Timer.h>
+
+#if defined(__AVR__) && defined(TIMSK1)
+#include <avr/interrupt.h>
+
+ISR(TIMER1_COMPA_vect) {
+    void (*isr)() = TLC5926Timer::compare_isr;
+    if (isr) isr();
+    }
+
+ISR(TIMER1_OVF_vect) {
+    void (*isr)() = TLC5926Timer::overflow_isr;
+    if (isr) isr();
+    }
+#endif
+
+static struct TLC5926TimerClaim {
+    TLC5926TimerClaim() { TLC5926Timer::claim(); }
+    } tlc5926_timer_claim; // before setup()
+
+#endif
@@ -103,6 +103,15 @@ void loop() {
       status = tlc.error_detect();
       Serial.print("Error Status: ");
       Serial.println(status,BIN);
+
+      // every chip in the chain, in one pass
+      TLC5926Diag diag[CHAIN_CT];
+      tlc.error_detect(diag, CHAIN_CT);
+      for (int i=0; i<CHAIN_CT; i++) {
+        Serial.print("Chip "); Serial.print(i);
+        Serial.print(" faults "); Serial.print(diag[i].faults,BIN);
+        Serial.println(diag[i].over_temp ? " over-temp?" : "");
+      }
       tlc.all(HIGH)->on()->delay(10000);
     }
     break;
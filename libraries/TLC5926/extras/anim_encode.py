@@ -0,0 +1,152 @@
+#!/usr/bin/env python3
+"""
+Encode frames into the TLC5926Anim format (see TLC5926Anim.h), as a PROGMEM C array or raw bytes.
+
+Input, one frame per line ('#' comments and blank lines skipped):
+    duration_ms hex-bytes
+hex-bytes are frame_bytes() long (2 per chip), in TLC5926::frame() order: the last chip's high byte first.
+    100 ff00 0000
+    100 00ff 0000   # spaces inside the hex are ignored
+
+    anim_encode.py frames.txt --name my_anim --loop > my_anim.h
+    anim_encode.py frames.txt --raw > my_anim.bin   # e.g. to send over a Stream
+"""
+
+import argparse
+import sys
+
+KEY, XOR, HOLD, END = 0x00, 0x40, 0x80, 0xC0
+DURATION, LOOP = 0x20, 0x01
+
+
+def rle(data):
+    # runs of 2+ same bytes as repeats, the rest as literal blocks, each up to 128
+    out = bytearray()
+    literal = bytearray()
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and run < 128 and data[i + run] == data[i]:
+            run += 1
+        if run >= 2:
+            if literal:
+                out += bytes([len(literal) - 1]) + literal
+                literal = bytearray()
+            out += bytes([0x80 | (run - 1), data[i]])
+            i += run
+        else:
+            literal.append(data[i])
+            if len(literal) == 128:
+                out += bytes([127]) + literal
+                literal = bytearray()
+            i += 1
+    if literal:
+        out += bytes([len(literal) - 1]) + literal
+    return out
+
+
+def encode(frames, loop):
+    out = bytearray()
+    current = None
+    duration = None
+    for ms, frame in frames:
+        if ms > 0xFFFF:
+            sys.exit("duration %d > 65535ms" % ms)
+        if current is not None and frame == current:
+            op, payload = HOLD, b""
+        else:
+            op, payload = KEY, rle(frame)
+            if current is not None:
+                delta = rle(bytes(a ^ b for a, b in zip(frame, current)))
+                if len(delta) < len(payload):
+                    op, payload = XOR, delta
+        if ms != duration:
+            out += bytes([op | DURATION, ms & 0xFF, ms >> 8])
+            duration = ms
+        else:
+            out.append(op)
+        out += payload
+        current = frame
+    out.append(END | (LOOP if loop else 0))
+    return out
+
+
+def decode(data, frame_bytes):
+    # what TLC5926Anim does, to check the encoding
+    frames = []
+    fb = bytearray(frame_bytes)
+    duration = 0
+    i = 0
+    while True:
+        op = data[i]
+        i += 1
+        if op & DURATION:
+            duration = data[i] | data[i + 1] << 8
+            i += 2
+        kind = op & 0xC0
+        if kind == END:
+            return frames
+        if kind in (KEY, XOR):
+            at = 0
+            while at < frame_bytes:
+                c = data[i]
+                i += 1
+                n = (c & 0x7F) + 1
+                for _ in range(n):
+                    if c & 0x80:
+                        b = data[i]
+                    else:
+                        b = data[i]
+                        i += 1
+                    fb[at] = fb[at] ^ b if kind == XOR else b
+                    at += 1
+                if c & 0x80:
+                    i += 1
+        frames.append((duration, bytes(fb)))
+
+
+def read_frames(f):
+    frames = []
+    for line_no, line in enumerate(f, 1):
+        line = line.split("#", 1)[0].split()
+        if not line:
+            continue
+        try:
+            frame = bytes.fromhex("".join(line[1:]))
+            frames.append((int(line[0]), frame))
+        except ValueError:
+            sys.exit("line %d: expected 'duration_ms hex-bytes'" % line_no)
+        if len(frame) != len(frames[0][1]) or not frame:
+            sys.exit("line %d: %d bytes, expected %d" % (line_no, len(frame), len(frames[0][1])))
+    if not frames:
+        sys.exit("no frames")
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Encode frames for TLC5926Anim")
+    parser.add_argument("frames", nargs="?", type=argparse.FileType("r"), default=sys.stdin)
+    parser.add_argument("--name", default="anim", help="C array name")
+    parser.add_argument("--loop", action="store_true", help="start over at the end")
+    parser.add_argument("--raw", action="store_true", help="write the bytes, not C")
+    args = parser.parse_args()
+
+    frames = read_frames(args.frames)
+    data = encode(frames, args.loop)
+    if decode(data, len(frames[0][1])) != frames:
+        sys.exit("encoding didn't round-trip, that's a bug")
+
+    if args.raw:
+        sys.stdout.buffer.write(data)
+        return
+
+    raw_ct = len(frames) * (len(frames[0][1]) + 3) + 1
+    print("// %d frames, %d bytes (%d%% of %d uncompressed)" % (len(frames), len(data), 100 * len(data) // raw_ct, raw_ct))
+    print("const byte %s[] PROGMEM = {" % args.name)
+    for i in range(0, len(data), 16):
+        print("    " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    print("    };")
+
+
+if __name__ == "__main__":
+    main()
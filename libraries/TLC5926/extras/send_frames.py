@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+"""
+Send frames to a TLC5926Receiver (see TLC5926Receiver.h), and say how fast that went.
+
+    send_frames.py --port /dev/ttyUSB0 --chips 4 frames.txt     # frames like anim_encode.py's input
+    send_frames.py --port /dev/ttyUSB0 --chips 4 --count 1000   # a walking bit, as fast as it goes
+    send_frames.py --out frames.bin --chips 4 frames.txt        # just write the bytes
+
+frames.txt lines are "duration_ms hex-bytes" (the duration is the pause after it, ignored with --fast).
+--port needs pyserial.
+"""
+
+import argparse
+import sys
+import time
+
+SYNC = bytes([0xA5, 0x5A])
+
+
+def packet(frame):
+    length = bytes([len(frame) & 0xFF, len(frame) >> 8])
+    checksum = (-sum(length + frame)) & 0xFF
+    return SYNC + length + frame + bytes([checksum])
+
+
+def walking_bit(frame_bytes, count):
+    bits = frame_bytes * 8
+    for i in range(count):
+        value = 1 << (i % bits)
+        yield 0, value.to_bytes(frame_bytes, "big")  # frame() order: channel 0 is the last bit
+
+
+def read_frames(f, frame_bytes):
+    for line_no, line in enumerate(f, 1):
+        line = line.split("#", 1)[0].split()
+        if not line:
+            continue
+        frame = bytes.fromhex("".join(line[1:]))
+        if len(frame) != frame_bytes:
+            sys.exit("line %d: %d bytes, expected %d" % (line_no, len(frame), frame_bytes))
+        yield int(line[0]), frame
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Send frames to a TLC5926Receiver")
+    parser.add_argument("frames", nargs="?", type=argparse.FileType("r"), help="default: a walking bit")
+    parser.add_argument("--chips", type=int, required=True, help="16 bit chips in the chain")
+    parser.add_argument("--count", type=int, default=100, help="walking-bit frames")
+    parser.add_argument("--port", help="serial port")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--out", type=argparse.FileType("wb"), help="write the bytes here instead")
+    parser.add_argument("--fast", action="store_true", help="no pauses between frames")
+    args = parser.parse_args()
+
+    frame_bytes = args.chips * 2
+    if args.frames:
+        frames = read_frames(args.frames, frame_bytes)
+    else:
+        frames = walking_bit(frame_bytes, args.count)
+
+    if args.out:
+        out = args.out
+    elif args.port:
+        import serial
+        out = serial.Serial(args.port, args.baud)
+        time.sleep(2)  # most Arduinos reset when the port opens
+    else:
+        sys.exit("--port or --out")
+
+    sent = 0
+    sent_bytes = 0
+    start = time.time()
+    for pause_ms, frame in frames:
+        data = packet(frame)
+        out.write(data)
+        sent += 1
+        sent_bytes += len(data)
+        if pause_ms and not args.fast:
+            out.flush()
+            time.sleep(pause_ms / 1000.0)
+    out.flush()
+    elapsed = time.time() - start
+
+    print("%d frames, %d bytes in %.2fs: %.1f frames/s, %.0f bytes/s"
+          % (sent, sent_bytes, elapsed, sent / elapsed if elapsed else 0, sent_bytes / elapsed if elapsed else 0),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
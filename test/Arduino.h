@@ -0,0 +1,157 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+/*
+    Host stand-in for the Arduino core, so the library builds and runs on Linux (see Makefile).
+
+    Pins are levels in memory. Every change is counted, and goes to the TLC5926Sim chains on those pins.
+    Time is simulated: each digitalWrite()/digitalRead() (or port-register write) costs sim_io_ns,
+    delay()/delayMicroseconds() just move the clock, millis()/micros() read it. No interrupts.
+    Pins are on 8-bit "ports" like an AVR (pin / 8, bit pin % 8), for the TLC5926_PORT_IO 1 build.
+    The harness side (levels, counts, traces) is in TLC5926Sim.h.
+*/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+#define F_CPU 16000000UL
+#define NOT_ON_TIMER 0
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define lowByte(w) ((uint8_t)((w) & 0xff))
+#define highByte(w) ((uint8_t)((w) >> 8))
+
+#define SIM_PINS 64
+// like an Uno
+#define MOSI 11
+#define MISO 12
+#define SCK 13
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+void analogWrite(int pin, int value);
+void shiftOut(int data_pin, int clock_pin, int bit_order, uint8_t value);
+int digitalPinToTimer(int pin); // NOT_ON_TIMER, unless sim_pin_timer() put it on one
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+inline void noInterrupts() { }
+inline void interrupts() { }
+
+// A port register: reading it is the levels of its 8 pins, writing it changes them all at once
+class SimPort {
+    public:
+        int port; // -1: not a pin (TLC5926Pin's unattached one)
+        uint8_t value; // ...which just keeps what's written
+
+        SimPort() : port(-1), value(0) { }
+        operator uint8_t() const;
+        SimPort &operator=(uint8_t v);
+        SimPort &operator|=(uint8_t bits) { return *this = *this | bits; }
+        SimPort &operator&=(uint8_t bits) { return *this = *this & bits; }
+    };
+
+// Timer1, just the registers, for TLC5926Dimmer's 12-bit mode: nothing counts or interrupts.
+// digitalWrite()/analogWrite() on a TIMER1A/TIMER1B pin clear/set its COM1x1, like the real ones.
+#define TIMER1A 3
+#define TIMER1B 4
+extern uint8_t TCCR1A, TCCR1B, TIMSK1;
+extern uint16_t OCR1A, OCR1B, ICR1;
+#define TCCR1A TCCR1A
+#define TCCR1B TCCR1B
+#define TIMSK1 TIMSK1
+#define OCR1A OCR1A
+#define OCR1B OCR1B
+#define ICR1 ICR1
+#define WGM10 0
+#define WGM11 1
+#define COM1B0 4
+#define COM1B1 5
+#define COM1A0 6
+#define COM1A1 7
+#define CS10 0
+#define CS11 1
+#define WGM12 3
+#define WGM13 4
+#define TOIE1 0
+#define OCIE1A 1
+#define _BV(bit) (1 << (bit))
+
+#define TLC5926_PORT_REG SimPort
+extern uint8_t SREG;
+inline void cli() { }
+inline void sei() { }
+inline int digitalPinToPort(int pin) { return pin / 8; }
+inline uint8_t digitalPinToBitMask(int pin) { return 1 << (pin % 8); }
+SimPort *portOutputRegister(int port);
+SimPort *portInputRegister(int port);
+
+class Print {
+    public:
+        virtual ~Print() { }
+        virtual size_t write(uint8_t b) = 0;
+        size_t write(const uint8_t *buffer, size_t size);
+        size_t print(const char *s);
+        size_t print(char c);
+        size_t print(int n, int base = DEC) { return print((long) n, base); }
+        size_t print(unsigned int n, int base = DEC) { return print((unsigned long) n, base); }
+        size_t print(long n, int base = DEC);
+        size_t print(unsigned long n, int base = DEC);
+        size_t print(double n, int digits = 2);
+        size_t println() { return print("\r\n"); }
+        template <class T> size_t println(T v) { size_t n = print(v); return n + println(); }
+        template <class T> size_t println(T v, int format) { size_t n = print(v, format); return n + println(); }
+    };
+
+class Stream : public Print {
+    protected:
+        unsigned long timeout; // ms
+
+    public:
+        Stream() : timeout(1000) { }
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+        void setTimeout(unsigned long ms) { timeout = ms; }
+        // like the real one: waits up to the timeout for a byte that isn't there (the sim clock moves)
+        size_t readBytes(uint8_t *buffer, size_t length);
+        size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *) buffer, length); }
+    };
+
+// stdout, nothing to read
+class HardwareSerial : public Stream {
+    public:
+        void begin(unsigned long) { }
+        size_t write(uint8_t b);
+        int available() { return 0; }
+        int read() { return -1; }
+        int peek() { return -1; }
+    };
+
+extern HardwareSerial Serial;
+
+#endif
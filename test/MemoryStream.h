@@ -0,0 +1,35 @@
+#ifndef MemoryStream_h
+#define MemoryStream_h
+
+/*
+    A Stream over bytes in memory, for TLC5926Anim/TLC5926Receiver. They're handed out as release()'d, so a test
+    can trickle them in like a slow serial line: available() is only what's been released and not read yet.
+    write() appends (released right away).
+*/
+
+#include <Arduino.h>
+#include <vector>
+
+class MemoryStream : public Stream {
+    public:
+        std::vector<uint8_t> data;
+        size_t at; // next to read
+        size_t released;
+
+        MemoryStream() : at(0), released(0) { }
+        MemoryStream(const uint8_t *bytes, size_t ct) : data(bytes, bytes + ct), at(0), released(0) { }
+        void release(size_t ct) { released = released + ct < data.size() ? released + ct : data.size(); }
+        void release_all() { released = data.size(); }
+        boolean drained() { return at == data.size(); }
+
+        int available() { return released - at; }
+        int read() { return at < released ? data[at++] : -1; }
+        int peek() { return at < released ? data[at] : -1; }
+        size_t write(uint8_t b) {
+            data.push_back(b);
+            released++;
+            return 1;
+            }
+    };
+
+#endif
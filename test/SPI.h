@@ -0,0 +1,47 @@
+#ifndef SPI_h
+#define SPI_h
+
+/*
+    Host stand-in for the Arduino SPI library.
+    transfer() clocks the byte out on MOSI/SCK (mode 0, MSB first), so TLC5926Sim sees the same edges
+    the peripheral would make, and MISO comes back. The time is the byte at the transaction's clock.
+    Every byte is kept in sent[] (since sim_reset()), to check frames byte-for-byte.
+*/
+
+#include <Arduino.h>
+#include <vector>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings {
+    public:
+        unsigned long clock;
+        uint8_t bit_order;
+        uint8_t data_mode;
+        SPISettings(unsigned long c = 4000000, uint8_t order = MSBFIRST, uint8_t mode = SPI_MODE0)
+            : clock(c), bit_order(order), data_mode(mode) { }
+    };
+
+class SPIClass {
+    public:
+        boolean enabled; // begin()..end(): the peripheral owns MOSI/SCK
+        boolean in_transaction;
+        SPISettings settings;
+        std::vector<uint8_t> sent;
+        unsigned long misuse; // transfer() outside begin()/beginTransaction(), or a transaction inside one
+
+        SPIClass() : enabled(false), in_transaction(false), misuse(0) { }
+        void begin();
+        void end();
+        void beginTransaction(SPISettings s);
+        void endTransaction();
+        uint8_t transfer(uint8_t b);
+        void reset(); // from sim_reset()
+    };
+
+extern SPIClass SPI;
+
+#endif
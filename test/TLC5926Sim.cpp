@@ -0,0 +1,148 @@
+#include <TLC5926Sim.h>
+
+static TLC5926Sim *chains[8]; // so several can share pins
+static int chain_ct = 0;
+
+TLC5926Sim::TLC5926Sim(int chips, int sdi_pin, int clk_pin, int le_pin, int oe_pin, int sdo_pin) {
+    ct = chips;
+    sdi = sdi_pin;
+    clk = clk_pin;
+    le = le_pin;
+    oe = oe_pin;
+    sdo = sdo_pin;
+    bits = new byte[ct];
+    shift_regs = new unsigned int[ct];
+    latches = new unsigned int[ct];
+    configs = new unsigned int[ct];
+    open = new unsigned int[ct];
+    for (int i = 0; i < ct; i++) {
+        bits[i] = 16;
+        shift_regs[i] = latches[i] = configs[i] = open[i] = 0;
+        }
+    special_mode = false;
+    oe_history = le_history = 0;
+    oe_low_clocks = 0;
+    oe_low_since = 0;
+    sdi_was = sim_pin(sdi);
+    le_was = le != -1 ? sim_pin(le) : LOW;
+    oe_was = oe != -1 ? sim_pin(oe) : LOW;
+    clear_counts();
+    if (chain_ct < 8) chains[chain_ct++] = this;
+    drive_sdo();
+    }
+
+TLC5926Sim::~TLC5926Sim() {
+    for (int i = 0; i < chain_ct; i++) {
+        if (chains[i] == this) chains[i] = chains[--chain_ct];
+        }
+    delete[] bits;
+    delete[] shift_regs;
+    delete[] latches;
+    delete[] configs;
+    delete[] open;
+    }
+
+TLC5926Sim *TLC5926Sim::widths(const byte *chip_bits) {
+    for (int i = 0; i < ct; i++) {
+        bits[i] = chip_bits[i];
+        shift_regs[i] = latches[i] = configs[i] = 0;
+        }
+    drive_sdo();
+    return this;
+    }
+
+TLC5926Sim *TLC5926Sim::faults(int chip, unsigned int open_channels) {
+    open[chip] = open_channels;
+    return this;
+    }
+
+void TLC5926Sim::clear_counts() {
+    clocks = latch_ct = mode_switches = status_loads = 0;
+    setup_violations = detect_too_soon = 0;
+    }
+
+int TLC5926Sim::chips() { return ct; }
+
+int TLC5926Sim::channels() {
+    int total = 0;
+    for (int i = 0; i < ct; i++) total += bits[i];
+    return total;
+    }
+
+unsigned int TLC5926Sim::shifted(int chip) { return shift_regs[chip]; }
+unsigned int TLC5926Sim::latched(int chip) { return latches[chip]; }
+unsigned int TLC5926Sim::config(int chip) { return configs[chip]; }
+boolean TLC5926Sim::special() { return special_mode; }
+boolean TLC5926Sim::enabled() { return oe == -1 || sim_pin(oe) == LOW; }
+unsigned int TLC5926Sim::outputs(int chip) { return enabled() ? latches[chip] : 0; }
+
+int TLC5926Sim::output(int channel) {
+    for (int chip = 0; chip < ct; chip++) {
+        if (channel < bits[chip]) return (outputs(chip) >> channel) & 1;
+        channel -= bits[chip];
+        }
+    return LOW;
+    }
+
+void TLC5926Sim::pins_changed(uint64_t pins) {
+    for (int i = 0; i < chain_ct; i++) chains[i]->changed(pins);
+    }
+
+void TLC5926Sim::changed(uint64_t pins) {
+    int le_now = le != -1 ? sim_pin(le) : LOW;
+    int oe_now = oe != -1 ? sim_pin(oe) : LOW;
+
+    if (clk != -1 && (pins >> clk) & 1 && sim_pin(clk)) {
+        // on the same write as the clock: too late, the chip sees the old levels
+        uint64_t inputs = (sdi != -1 ? 1ULL << sdi : 0) | (le != -1 ? 1ULL << le : 0) | (oe != -1 ? 1ULL << oe : 0);
+        if (pins & inputs) setup_violations++;
+        clock(sdi_was, le_was, oe_was);
+        }
+    if (oe_now != oe_was) {
+        if (oe_now == LOW) oe_low_since = sim_ns;
+        else oe_low_clocks = 0;
+        }
+    if (le_was && !le_now) latch();
+
+    sdi_was = sdi != -1 ? sim_pin(sdi) : LOW;
+    le_was = le_now;
+    oe_was = oe_now;
+    }
+
+void TLC5926Sim::clock(int in, int le_level, int oe_level) {
+    clocks++;
+    for (int i = 0; i < ct; i++) {
+        int out = (shift_regs[i] >> (bits[i] - 1)) & 1;
+        shift_regs[i] = ((shift_regs[i] << 1) | in) & mask(i);
+        in = out;
+        }
+
+    oe_history = ((oe_history << 1) | oe_level) & 0x1F;
+    le_history = ((le_history << 1) | le_level) & 0x1F;
+    if (oe != -1 && oe_history == 0x17 && !(le_history & 0x1D)) { // /OE 1,0,1,1,1, LE 0,0,0,?,0
+        special_mode = le_history & 0x02;
+        mode_switches++;
+        oe_low_clocks = 0;
+        }
+    else if (special_mode && oe_level == LOW && ++oe_low_clocks == 3) {
+        if (sim_ns - oe_low_since < 2000) detect_too_soon++;
+        for (int i = 0; i < ct; i++) shift_regs[i] = latches[i] & ~open[i] & mask(i);
+        status_loads++;
+        }
+
+    if (le == -1 && !special_mode) latch(); // LE tied to CLK
+    drive_sdo();
+    }
+
+void TLC5926Sim::latch() {
+    if ((oe_history & 0x0F) == 0x0B) return; // the LE of a mode switch
+    for (int i = 0; i < ct; i++) {
+        if (special_mode) configs[i] = shift_regs[i];
+        else latches[i] = shift_regs[i];
+        }
+    latch_ct++;
+    }
+
+void TLC5926Sim::drive_sdo() {
+    if (sdo != -1 && ct) sim_drive(sdo, (shift_regs[ct - 1] >> (bits[ct - 1] - 1)) & 1);
+    }
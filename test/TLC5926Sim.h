@@ -0,0 +1,88 @@
+#ifndef TLC5926Sim_h
+#define TLC5926Sim_h
+
+/*
+    A model of a chain of TLC5926/TLC5927's (or TLC5916/TLC5917's, see widths()) on the host's pins.
+
+        TLC5926Sim chain(3, SDI_pin, CLK_pin, LE_pin, iOE_pin, SDO_pin);
+        tlc.attach(3, SDI_pin, CLK_pin, LE_pin, iOE_pin, SDO_pin)->set(17)->flush();
+        CHECK(chain.output(17));
+
+    Per the datasheet: data shifts in on CLK rising, first chip first. LE high->low latches the shift registers:
+    into the outputs in normal mode, into the configuration in special mode. /OE low turns the outputs on.
+    /OE 1,0,1,1,1 on five CLK rises switches mode: LE high on the 4th is special mode, low is normal.
+    In special mode, /OE low for 3 CLK rises (2us or more) loads the error status into the shift registers.
+    SDO is the last chip's MSB.
+    What would be marginal on real hardware is counted, not modeled: a write that changes SDI/LE/OE at the same
+    time as CLK rises (no setup time, the old levels are used), or an error detect before 2us.
+*/
+
+#include <Arduino.h>
+#include <vector>
+
+class TLC5926Sim {
+    private:
+        int ct;
+        int sdi, clk, le, oe, sdo;
+        byte *bits; // per chip, 8 or 16
+        unsigned int *shift_regs, *latches, *configs, *open;
+        boolean special_mode;
+        byte oe_history, le_history; // at the last 5 CLK rises, newest is bit 0
+        int oe_low_clocks; // special mode, for the error status
+        unsigned long long oe_low_since;
+        int sdi_was, le_was, oe_was;
+
+        unsigned int mask(int chip) { return bits[chip] == 16 ? 0xFFFF : 0xFF; }
+        void clock(int in, int le_level, int oe_level);
+        void latch();
+        void drive_sdo();
+        void changed(uint64_t pins);
+
+    public:
+        // LE -1: tied to CLK, so it latches every clock. /OE -1: tied low, always on
+        TLC5926Sim(int chips, int sdi_pin, int clk_pin, int le_pin = -1, int oe_pin = -1, int sdo_pin = -1);
+        ~TLC5926Sim();
+        TLC5926Sim *widths(const byte *chip_bits); // first chip first, 8 or 16. Clears the registers
+        TLC5926Sim *faults(int chip, unsigned int open_channels); // read back as 0 in error detect
+
+        int chips();
+        int channels();
+        unsigned int shifted(int chip); // the shift register, bit n is OUTn
+        unsigned int latched(int chip);
+        unsigned int config(int chip); // the configuration latch, as shifted in
+        int output(int channel); // channel 0 is OUT0 of the first chip: latched, and /OE on
+        unsigned int outputs(int chip);
+        boolean special(); // configuration/error-detect mode
+        boolean enabled(); // /OE low
+
+        // since made, or clear_counts()
+        unsigned long clocks, latch_ct, mode_switches, status_loads;
+        unsigned long setup_violations, detect_too_soon;
+        void clear_counts();
+
+        static void pins_changed(uint64_t pins); // from the pins, after the levels changed
+    };
+
+// The pins and the clock (the harness side of Arduino.h)
+struct SimEdge {
+    int pin;
+    int level;
+    unsigned long long ns;
+    unsigned long write; // edges from one write (e.g. a port write) share it
+    };
+
+extern unsigned long long sim_ns; // simulated time
+extern unsigned long sim_io_ns; // one pin access (digitalWrite, a port write...). Default 125, 2 cycles at 16MHz
+extern unsigned long sim_edges; // pin changes by the "cpu" (not SDO), since sim_reset()
+extern unsigned long sim_writes; // digitalWrite()'s and port writes, changed or not
+
+void sim_reset(); // all pins low, time 0, counts 0, no trace, SPI idle, Timer1 cleared and no pins on it. A TLC5926Sim keeps its registers
+int sim_pin(int pin);
+void sim_write(uint64_t pins, uint64_t levels); // at the same time (a port write), no cost
+void sim_drive(int pin, int level); // a chip's output (SDO): no cost, not an edge
+int sim_pwm(int pin); // the last analogWrite(), -1 if digital since
+void sim_pin_timer(int pin, int timer); // digitalPinToTimer(pin), e.g. TIMER1A. Until sim_reset()
+void sim_trace(boolean on); // record the edges, from now (cleared)
+const std::vector<SimEdge> &sim_traced();
+
+#endif
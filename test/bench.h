@@ -0,0 +1,50 @@
+#ifndef bench_h
+#define bench_h
+
+/*
+    make bench: timings on the host build (the ports one, like AVR), as CSV on stdout, so runs can be diffed:
+
+        bench,case,ops,edges_per_op,sim_us_per_op,wall_ns_per_op,sim_ops_per_sec
+
+    edges are pin changes counted by the stand-in core (see TLC5926Sim.h), sim_us is simulated time at sim_io_ns
+    per pin access (2 cycles at 16MHz), so roughly what an Uno would take. wall_ns is this machine, for the pure
+    computation (e.g. transpose8). sim_ops_per_sec is 0 if it took no simulated time.
+
+        BENCH(multi) {
+            TLC5926Multi chains; ...
+            bench("multi", "send 8 chains", 100, [&](long i) { chains.send(); });
+            }
+*/
+
+#include <Arduino.h>
+#include <TLC5926Sim.h>
+#include <stdio.h>
+#include <time.h>
+
+struct BenchCase {
+    const char *name;
+    void (*fn)();
+    BenchCase *next;
+    BenchCase(const char *bench_name, void (*bench_fn)());
+    };
+
+#define BENCH(name) \
+    static void bench_##name(); \
+    static BenchCase bench_case_##name(#name, bench_##name); \
+    static void bench_##name()
+
+unsigned long long wall_ns();
+void bench_report(const char *name, const char *label, long ops, unsigned long edges, unsigned long long sim,
+    unsigned long long wall);
+
+// op(i) for i in 0..ops-1, measured together
+template <class Op> void bench(const char *name, const char *label, long ops, Op op) {
+    unsigned long edges = sim_edges;
+    unsigned long long sim = sim_ns;
+    unsigned long long wall = wall_ns();
+    for (long i = 0; i < ops; i++) op(i);
+    wall = wall_ns() - wall;
+    bench_report(name, label, ops, sim_edges - edges, sim_ns - sim, wall);
+    }
+
+#endif
@@ -0,0 +1,53 @@
+// TLC5926 by chain length and transport: send/all/flush/send_bits/config/error_detect, and shiftOut() as the
+// baseline for a frame. Pin edges and simulated time per op, bit-banged and SPI, from 1 chip to MAX_CHIPS.
+#include "bench.h"
+#include <TLC5926SPI.h>
+#include <TLC5926.h>
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5, SDO = 6; // one port, like the tests
+static const int MAX_CHIPS = 64;
+
+static void bench_chain(boolean use_spi, int chips) {
+    const char *transport = use_spi ? "spi" : "pins";
+    char label[40];
+    static unsigned int status[MAX_CHIPS];
+    TLC5926Sim chain(chips, use_spi ? MOSI : SDI, use_spi ? SCK : CLK, LE, OE, SDO);
+    TLC5926 tlc;
+    if (use_spi) tlc.attach_spi(chips, LE, OE, SDO);
+    else tlc.attach(chips, SDI, CLK, LE, OE, SDO);
+    long ops = chips < 16 ? 100 : 20;
+
+#define CASE(op, code) \
+    snprintf(label, sizeof(label), "%s %d chips " op, transport, chips); \
+    bench("chain", label, ops, [&](long i) { (void) i; code; });
+
+    CASE("send", tlc.send(i));
+    CASE("all", tlc.all(i & 1));
+    CASE("flush", tlc.set_word(0, i)->flush()); // a frame
+    CASE("send_bits", tlc.send_bits(16, i));
+    tlc.config(HIGH, HIGH, 0); // the first one always switches
+    CASE("config", tlc.config(HIGH, HIGH, i & 1 ? 63 : 0)); // a change each time, or it does nothing
+    CASE("error_detect", tlc.error_detect(status, chips));
+#undef CASE
+    }
+
+static void bench_shiftOut(int chips) {
+    // what flush() would be, the plain Arduino way
+    char label[40];
+    TLC5926Sim chain(chips, SDI, CLK, LE, OE);
+    pinMode(LE, OUTPUT);
+    snprintf(label, sizeof(label), "shiftOut %d chips flush", chips);
+    bench("chain", label, chips < 16 ? 100 : 20, [&](long i) {
+        for (int b = 0; b < chips * 2; b++) shiftOut(SDI, CLK, MSBFIRST, i + b);
+        digitalWrite(LE, HIGH);
+        digitalWrite(LE, LOW);
+        });
+    }
+
+BENCH(chain) {
+    for (int chips = 1; chips <= MAX_CHIPS; chips *= 2) {
+        bench_chain(false, chips);
+        bench_chain(true, chips);
+        bench_shiftOut(chips);
+        }
+    }
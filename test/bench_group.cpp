@@ -0,0 +1,26 @@
+// TLC5926Group: n chains of 4 chips on one CLK in one pass, against flush()'ing them one after the other
+#include "bench.h"
+#include <TLC5926Group.h>
+
+BENCH(group) {
+    const int CHIPS = 4, CLK = 8, LE = 9, OE = 10;
+    char label[40];
+    for (int n = 1; n <= 8; n *= 2) {
+        TLC5926 *tlcs = new TLC5926[n];
+        TLC5926Group group;
+        for (int m = 0; m < n; m++) {
+            tlcs[m].attach(CHIPS, m, CLK, LE, OE);
+            group.add(&tlcs[m]);
+            }
+        snprintf(label, sizeof(label), "%d chains of %d group", n, CHIPS);
+        bench("group", label, 100, [&](long i) {
+            for (int m = 0; m < n; m++) tlcs[m].set_word(m % CHIPS, i * 0x0101 + m);
+            group.flush();
+            });
+        snprintf(label, sizeof(label), "%d chains of %d sequential", n, CHIPS);
+        bench("group", label, 100, [&](long i) {
+            for (int m = 0; m < n; m++) tlcs[m].set_word(m % CHIPS, i * 0x0101 + m + 1)->flush();
+            });
+        delete[] tlcs;
+        }
+    }
@@ -0,0 +1,58 @@
+// TLC5926Multi: transpose8() itself, and n chains off one clock against n TLC5926's one after the other
+#include "bench.h"
+#include <TLC5926.h>
+#include <TLC5926Multi.h>
+
+static void naive_transpose8(const byte in[8], byte out[8]) {
+    for (int k = 0; k < 8; k++) {
+        out[k] = 0;
+        for (int b = 0; b < 8; b++) out[k] |= ((in[b] >> (7 - k)) & 1) << b;
+        }
+    }
+
+static volatile byte sink;
+
+BENCH(transpose8) {
+    byte in[8], out[8];
+    const long ops = 2000000;
+    for (int i = 0; i < 8; i++) in[i] = i * 37;
+    bench("transpose8", "hackers delight", ops, [&](long i) {
+        in[i & 7] ^= i;
+        TLC5926Multi::transpose8(in, out);
+        sink = out[i & 7];
+        });
+    bench("transpose8", "naive", ops, [&](long i) {
+        in[i & 7] ^= i;
+        naive_transpose8(in, out);
+        sink = out[i & 7];
+        });
+    }
+
+BENCH(multi) {
+    const int CHIPS = 4, CLK = 8, LE = 9, OE = 10;
+    static byte frames[8][2 * CHIPS];
+    char label[40];
+    for (int lane = 0; lane < 8; lane++) {
+        for (int b = 0; b < 2 * CHIPS; b++) frames[lane][b] = 0x55 ^ (lane * 29 + b * 7);
+        }
+    for (int n = 1; n <= 8; n *= 2) {
+        TLC5926Multi multi;
+        multi.attach(CHIPS, CLK, LE, OE);
+        for (int lane = 0; lane < n; lane++) multi.add_chain(lane, frames[lane]);
+        snprintf(label, sizeof(label), "%d chains of %d multi", n, CHIPS);
+        bench("multi", label, 100, [&](long i) {
+            frames[0][0] = i;
+            multi.send();
+            });
+
+        TLC5926 *tlcs = new TLC5926[n];
+        for (int lane = 0; lane < n; lane++) tlcs[lane].attach(CHIPS, lane, CLK, LE, OE);
+        snprintf(label, sizeof(label), "%d chains of %d sequential", n, CHIPS);
+        bench("multi", label, 100, [&](long i) {
+            frames[0][0] = i;
+            for (int lane = 0; lane < n; lane++) tlcs[lane].shift_bytes(frames[lane], 2 * CHIPS);
+            tlcs[0].latch_pulse(); // LE is shared
+            });
+        delete[] tlcs;
+        }
+    }
@@ -0,0 +1,51 @@
+// TLC5926Receiver: whole packets (extras/send_frames.py's format) through poll(), by chain length, with LE
+// (shifted as they come) and without (framebuffer, then flush()). At 115200 baud a byte takes ~87us to arrive,
+// so it keeps up as long as sim_us_per_op is under 87us * (frame_bytes + 5).
+#include "bench.h"
+#include <TLC5926Receiver.h>
+#include "MemoryStream.h"
+
+static void packet(MemoryStream &stream, const byte *frame, int len) {
+    // like send_frames.py's packet()
+    byte sum = (len & 0xFF) + (len >> 8);
+    stream.write(0xA5);
+    stream.write(0x5A);
+    stream.write(len & 0xFF);
+    stream.write(len >> 8);
+    for (int i = 0; i < len; i++) {
+        stream.write(frame[i]);
+        sum += frame[i];
+        }
+    stream.write(-sum);
+    }
+
+BENCH(receiver) {
+    const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+    const long FRAMES = 200;
+    char label[40];
+    for (int chips = 1; chips <= 16; chips *= 2) {
+        for (int with_le = 1; with_le >= 0; with_le--) {
+            MemoryStream stream;
+            byte frame[32];
+            for (long f = 0; f < FRAMES; f++) {
+                for (int i = 0; i < 2 * chips; i++) frame[i] = f * 7 + i * 13;
+                packet(stream, frame, 2 * chips);
+                }
+            stream.at = stream.released = 0;
+            int packet_bytes = 2 * chips + 5;
+
+            TLC5926 tlc;
+            if (with_le) tlc.attach(chips, SDI, CLK, LE, OE);
+            else tlc.attach(chips, SDI, CLK);
+            TLC5926Receiver rx;
+            rx.attach(&tlc, stream);
+            snprintf(label, sizeof(label), "%d chips %s", chips, with_le ? "LE" : "no LE");
+            bench("receiver", label, FRAMES, [&](long i) {
+                (void) i;
+                stream.release(packet_bytes);
+                rx.poll();
+                });
+            if (rx.frames() != FRAMES) printf("# %s: %lu frames of %ld\n", label, rx.frames(), FRAMES);
+            }
+        }
+    }
@@ -0,0 +1,237 @@
+// The host's Arduino core: pins, clock, Serial and SPI (see Arduino.h), wired to TLC5926Sim
+#include <Arduino.h>
+#include <SPI.h>
+#include <TLC5926Sim.h>
+#include <stdio.h>
+
+unsigned long long sim_ns = 0;
+unsigned long sim_io_ns = 125;
+unsigned long sim_edges = 0;
+unsigned long sim_writes = 0;
+uint8_t SREG = 0;
+HardwareSerial Serial;
+SPIClass SPI;
+
+static uint64_t levels = 0;
+static int pwm[SIM_PINS];
+static boolean tracing = false;
+static std::vector<SimEdge> trace;
+static SimPort ports[SIM_PINS / 8];
+static int timers[SIM_PINS];
+uint8_t TCCR1A, TCCR1B, TIMSK1;
+uint16_t OCR1A, OCR1B, ICR1;
+
+void sim_reset() {
+    levels = 0;
+    for (int i = 0; i < SIM_PINS; i++) pwm[i] = -1;
+    for (int i = 0; i < SIM_PINS; i++) timers[i] = NOT_ON_TIMER;
+    TCCR1A = TCCR1B = TIMSK1 = 0;
+    OCR1A = OCR1B = ICR1 = 0;
+    for (int i = 0; i < SIM_PINS / 8; i++) ports[i].port = i;
+    sim_ns = 0;
+    sim_io_ns = 125;
+    sim_edges = sim_writes = 0;
+    tracing = false;
+    trace.clear();
+    SPI.reset();
+    }
+
+int sim_pin(int pin) {
+    return pin >= 0 && pin < SIM_PINS ? (levels >> pin) & 1 : LOW;
+    }
+
+void sim_write(uint64_t pins, uint64_t to) {
+    uint64_t changed = (levels ^ to) & pins;
+    if (!changed) return;
+    static unsigned long write = 0;
+    levels ^= changed;
+    write++;
+    for (int pin = 0; pin < SIM_PINS; pin++) {
+        if (!((changed >> pin) & 1)) continue;
+        sim_edges++;
+        if (tracing) {
+            SimEdge edge = { pin, sim_pin(pin), sim_ns, write };
+            trace.push_back(edge);
+            }
+        }
+    TLC5926Sim::pins_changed(changed);
+    }
+
+void sim_drive(int pin, int level) {
+    if (pin < 0 || pin >= SIM_PINS) return;
+    if (level) levels |= 1ULL << pin;
+    else levels &= ~(1ULL << pin);
+    }
+
+int sim_pwm(int pin) { return pin >= 0 && pin < SIM_PINS ? pwm[pin] : -1; }
+
+void sim_pin_timer(int pin, int timer) {
+    if (pin >= 0 && pin < SIM_PINS) timers[pin] = timer;
+    }
+
+static uint8_t com1(int pin) {
+    // the pin's COM1x1 bit, 0 if it isn't on Timer1
+    int timer = digitalPinToTimer(pin);
+    return timer == TIMER1A ? _BV(COM1A1) : timer == TIMER1B ? _BV(COM1B1) : 0;
+    }
+
+void sim_trace(boolean on) {
+    tracing = on;
+    trace.clear();
+    }
+
+const std::vector<SimEdge> &sim_traced() { return trace; }
+
+// Arduino
+
+void pinMode(int, int) {
+    sim_ns += sim_io_ns;
+    }
+
+void digitalWrite(int pin, int value) {
+    sim_ns += sim_io_ns;
+    sim_writes++;
+    if (pin < 0 || pin >= SIM_PINS) return;
+    pwm[pin] = -1;
+    TCCR1A &= ~com1(pin); // turnOffPWM()
+    sim_write(1ULL << pin, value ? 1ULL << pin : 0);
+    }
+
+int digitalPinToTimer(int pin) {
+    return pin >= 0 && pin < SIM_PINS ? timers[pin] : NOT_ON_TIMER;
+    }
+
+int digitalRead(int pin) {
+    sim_ns += sim_io_ns;
+    return sim_pin(pin);
+    }
+
+void analogWrite(int pin, int value) {
+    sim_ns += sim_io_ns;
+    if (pin < 0 || pin >= SIM_PINS) return;
+    // like the real one: the ends are plain digital
+    if (value <= 0 || value >= 255) digitalWrite(pin, value > 0);
+    else {
+        pwm[pin] = value;
+        TCCR1A |= com1(pin);
+        if (digitalPinToTimer(pin) == TIMER1A) OCR1A = value;
+        if (digitalPinToTimer(pin) == TIMER1B) OCR1B = value;
+        }
+    }
+
+void shiftOut(int data_pin, int clock_pin, int bit_order, uint8_t value) {
+    for (int i = 0; i < 8; i++) {
+        digitalWrite(data_pin, bit_order == LSBFIRST ? (value >> i) & 1 : (value >> (7 - i)) & 1);
+        digitalWrite(clock_pin, HIGH);
+        digitalWrite(clock_pin, LOW);
+        }
+    }
+
+unsigned long millis() { return sim_ns / 1000000ULL; }
+unsigned long micros() { return sim_ns / 1000ULL; }
+void delay(unsigned long ms) { sim_ns += ms * 1000000ULL; }
+void delayMicroseconds(unsigned int us) { sim_ns += us * 1000ULL; }
+
+SimPort::operator uint8_t() const {
+    return port == -1 ? value : (uint8_t)(levels >> (port * 8));
+    }
+
+SimPort &SimPort::operator=(uint8_t v) {
+    if (port == -1) {
+        value = v;
+        return *this;
+        }
+    sim_ns += sim_io_ns;
+    sim_writes++;
+    sim_write(0xFFULL << (port * 8), (uint64_t) v << (port * 8));
+    return *this;
+    }
+
+SimPort *portOutputRegister(int port) { return &ports[port]; }
+SimPort *portInputRegister(int port) { return &ports[port]; }
+
+// Print, Stream, Serial
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) n += write(*buffer++);
+    return n;
+    }
+
+size_t Print::print(const char *s) { return write((const uint8_t *) s, strlen(s)); }
+
+size_t Print::print(char c) { return write(c); }
+
+size_t Print::print(long n, int base) {
+    if (base == DEC && n < 0) return print('-') + print((unsigned long) -n, DEC);
+    return print((unsigned long) n, base);
+    }
+
+size_t Print::print(unsigned long n, int base) {
+    char digits[8 * sizeof(n) + 1];
+    char *at = &digits[sizeof(digits) - 1];
+    *at = 0;
+    if (base < 2) base = DEC;
+    do {
+        int d = n % base;
+        *--at = d < 10 ? '0' + d : 'A' + d - 10;
+        n /= base;
+        } while (n);
+    return print(at);
+    }
+
+size_t Print::print(double n, int digits) {
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, n);
+    return print(text);
+    }
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length) {
+    size_t n = 0;
+    while (n < length) {
+        if (available() <= 0) {
+            sim_ns += timeout * 1000000ULL; // nothing more is coming
+            break;
+            }
+        buffer[n++] = read();
+        }
+    return n;
+    }
+
+size_t HardwareSerial::write(uint8_t b) { return fwrite(&b, 1, 1, stdout); }
+
+// SPI
+
+void SPIClass::reset() {
+    enabled = in_transaction = false;
+    settings = SPISettings();
+    sent.clear();
+    misuse = 0;
+    }
+
+void SPIClass::begin() { enabled = true; }
+
+void SPIClass::end() { enabled = false; }
+
+void SPIClass::beginTransaction(SPISettings s) {
+    if (in_transaction) misuse++;
+    settings = s;
+    in_transaction = true;
+    }
+
+void SPIClass::endTransaction() { in_transaction = false; }
+
+uint8_t SPIClass::transfer(uint8_t b) {
+    if (!enabled || !in_transaction) misuse++;
+    sent.push_back(b);
+    sim_ns += 8 * 1000000000ULL / settings.clock;
+    uint8_t in = 0;
+    for (int i = 7; i >= 0; i--) {
+        int bit = settings.bit_order == LSBFIRST ? 7 - i : i;
+        sim_write(1ULL << MOSI, (uint64_t)((b >> bit) & 1) << MOSI);
+        in |= sim_pin(MISO) << bit; // sampled on the rising edge, before the chip moves on
+        sim_write(1ULL << SCK, 1ULL << SCK);
+        sim_write(1ULL << SCK, 0);
+        }
+    return in;
+    }
@@ -0,0 +1 @@
+// host build: the pin definitions are in Arduino.h
@@ -0,0 +1,37 @@
+// make bench: runs every BENCH(), or just the ones whose names contain an argument
+#include "bench.h"
+
+static BenchCase *first = NULL, *last = NULL;
+
+BenchCase::BenchCase(const char *bench_name, void (*bench_fn)()) {
+    name = bench_name;
+    fn = bench_fn;
+    next = NULL;
+    if (last) last->next = this;
+    else first = this;
+    last = this;
+    }
+
+unsigned long long wall_ns() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+    }
+
+void bench_report(const char *name, const char *label, long ops, unsigned long edges, unsigned long long sim,
+        unsigned long long wall) {
+    printf("%s,%s,%ld,%.1f,%.2f,%.1f,%.0f\n", name, label, ops, (double) edges / ops, sim / 1000.0 / ops,
+        (double) wall / ops, sim ? 1e9 * ops / sim : 0.0);
+    }
+
+int main(int argc, char **argv) {
+    printf("bench,case,ops,edges_per_op,sim_us_per_op,wall_ns_per_op,sim_ops_per_sec\n");
+    for (BenchCase *b = first; b; b = b->next) {
+        boolean wanted = argc < 2;
+        for (int i = 1; i < argc; i++) wanted |= strstr(b->name, argv[i]) != NULL;
+        if (!wanted) continue;
+        sim_reset();
+        b->fn();
+        }
+    return 0;
+    }
@@ -0,0 +1,40 @@
+// make test: runs every TEST(), or just the ones whose names contain an argument
+#include "test.h"
+
+static TestCase *first = NULL, *last = NULL;
+int test_failures = 0;
+
+TestCase::TestCase(const char *test_name, void (*test_fn)()) {
+    name = test_name;
+    fn = test_fn;
+    next = NULL;
+    if (last) last->next = this;
+    else first = this;
+    last = this;
+    }
+
+static bool wanted(const char *name, int argc, char **argv) {
+    if (argc < 2) return true;
+    for (int i = 1; i < argc; i++) {
+        if (strstr(name, argv[i])) return true;
+        }
+    return false;
+    }
+
+int main(int argc, char **argv) {
+    setvbuf(stdout, NULL, _IONBF, 0);
+    int run = 0, failed = 0;
+    for (TestCase *t = first; t; t = t->next) {
+        if (!wanted(t->name, argc, argv)) continue;
+        sim_reset();
+        test_failures = 0;
+        t->fn();
+        run++;
+        if (test_failures) {
+            printf("FAIL %s\n", t->name);
+            failed++;
+            }
+        }
+    printf("%d tests, %d failed\n", run, failed);
+    return failed ? 1 : 0;
+    }
@@ -0,0 +1,50 @@
+#ifndef test_h
+#define test_h
+
+/*
+    Just enough of a test runner. A test is a function, registered by TEST(), run in order of the files (see Makefile).
+    Every test starts from sim_reset(). A failed CHECK prints where, and the test goes on.
+
+        TEST(send_latches) {
+            TLC5926Sim chain(1, 2, 3, 4, 5);
+            TLC5926 tlc;
+            tlc.attach(1, 2, 3, 4, 5)->send(0x8001);
+            CHECK_EQ(chain.outputs(0), 0x8001u);
+            }
+*/
+
+#include <Arduino.h>
+#include <TLC5926Sim.h>
+#include <stdio.h>
+
+struct TestCase {
+    const char *name;
+    void (*fn)();
+    TestCase *next;
+    TestCase(const char *test_name, void (*test_fn)());
+    };
+
+extern int test_failures; // in the current test
+
+#define TEST(name) \
+    static void test_##name(); \
+    static TestCase test_case_##name(#name, test_##name); \
+    static void test_##name()
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        test_failures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(got, want) do { \
+    unsigned long long got_ = (unsigned long long)(got), want_ = (unsigned long long)(want); \
+    if (got_ != want_) { \
+        printf("%s:%d: %s is 0x%llX (%llu), expected %s 0x%llX (%llu)\n", \
+            __FILE__, __LINE__, #got, got_, got_, #want, want_, want_); \
+        test_failures++; \
+        } \
+    } while (0)
+
+#endif
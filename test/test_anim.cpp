@@ -0,0 +1,155 @@
+// TLC5926Anim: what extras/anim_encode.py made of anim_frames.txt (build/anim_test.h), played from PROGMEM, and
+// from a Stream that trickles in, against the frames in the file
+#include "test.h"
+#include <TLC5926Anim.h>
+#include "MemoryStream.h"
+#include "build/anim_test.h"
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+
+struct Shown {
+    unsigned long ms; // for how long
+    uint32_t bits; // chip 1's outputs, then chip 0's: the frame bytes in order
+    };
+
+static std::vector<Shown> want_frames() {
+    // anim_frames.txt, the way anim_encode.py reads it. A HOLD (or the same frame again) is one longer frame
+    std::vector<Shown> frames;
+    FILE *f = fopen("anim_frames.txt", "r");
+    char line[200];
+    while (f && fgets(line, sizeof(line), f)) {
+        char *comment = strchr(line, '#');
+        if (comment) *comment = 0;
+        unsigned long ms;
+        unsigned int high, low;
+        if (sscanf(line, "%lu %x %x", &ms, &high, &low) != 3) continue;
+        Shown frame = { ms, (uint32_t) high << 16 | low };
+        if (!frames.empty() && frames.back().bits == frame.bits) frames.back().ms += ms;
+        else frames.push_back(frame);
+        }
+    if (f) fclose(f);
+    return frames;
+    }
+
+static uint32_t showing(TLC5926Sim &chain) {
+    return (uint32_t) chain.outputs(1) << 16 | chain.outputs(0);
+    }
+
+// update() every ms (trickling a byte in first, if a stream) till it ends. longest: the slowest update()
+static std::vector<Shown> watch(TLC5926Anim &anim, TLC5926Sim &chain, MemoryStream *stream,
+        unsigned long long &longest) {
+    std::vector<Shown> seen;
+    unsigned long since = millis();
+    longest = 0;
+    for (int ms = 0; ms < 10000 && anim.playing(); ms++) {
+        if (stream) stream->release(1);
+        unsigned long long was = sim_ns;
+        anim.update();
+        if (sim_ns - was > longest) longest = sim_ns - was;
+        if (seen.empty() || seen.back().bits != showing(chain)) {
+            if (!seen.empty()) seen.back().ms = millis() - since;
+            Shown frame = { 0, showing(chain) };
+            seen.push_back(frame);
+            since = millis();
+            }
+        delay(1);
+        }
+    if (!seen.empty()) seen.back().ms = millis() - since;
+    return seen;
+    }
+
+TEST(anim_progmem_plays_the_frames) {
+    std::vector<Shown> want = want_frames();
+    CHECK_EQ(want.size(), 6);
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Anim anim;
+    anim.attach(&tlc)->play(anim_test);
+    CHECK(anim.playing());
+    unsigned long long longest;
+    std::vector<Shown> seen = watch(anim, chain, NULL, longest);
+    CHECK(!anim.playing());
+    CHECK_EQ(seen.size(), want.size());
+    for (size_t i = 0; i < seen.size() && i < want.size(); i++) {
+        CHECK_EQ(seen[i].bits, want[i].bits);
+        CHECK(seen[i].ms >= want[i].ms && seen[i].ms <= want[i].ms + 2);
+        }
+    }
+
+TEST(anim_stream_doesnt_wait_for_bytes) {
+    // a byte a ms: frames come in over several update()s, none of which waits for the rest
+    std::vector<Shown> want = want_frames();
+    MemoryStream stream(anim_test, sizeof(anim_test));
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Anim anim;
+    anim.attach(&tlc)->play(stream);
+    CHECK(anim.playing()); // nothing yet, that's not the end
+    CHECK(anim.update());
+    unsigned long long longest;
+    std::vector<Shown> seen = watch(anim, chain, &stream, longest);
+    CHECK(!anim.playing()); // the END op
+    CHECK(stream.drained());
+    CHECK(longest < 1000000); // under a ms: readBytes() would have sat out its 1s timeout
+    CHECK_EQ(seen.size(), want.size() + 1); // the outputs were 0 to start with
+    for (size_t i = 1; i < seen.size() && i <= want.size(); i++) {
+        CHECK_EQ(seen[i].bits, want[i - 1].bits);
+        CHECK(seen[i].ms >= want[i - 1].ms); // and then however long the next one took to arrive
+        }
+    }
+
+TEST(anim_stream_resumes_mid_frame) {
+    // the first frame, all but its last byte: nothing shows until that comes in
+    MemoryStream stream(anim_test, sizeof(anim_test));
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Anim anim;
+    anim.attach(&tlc);
+    stream.release(6);
+    anim.play(stream);
+    CHECK(anim.update());
+    CHECK_EQ(chain.latch_ct, 0);
+    CHECK_EQ(stream.available(), 0);
+    stream.release(1);
+    CHECK(anim.update());
+    CHECK_EQ(chain.latch_ct, 1);
+    CHECK_EQ(showing(chain), 0x0F0FF0F0u);
+    }
+
+TEST(anim_empty_loop_stops) {
+    // END|LOOP with no frame before it (or only HOLDs) would go around forever without showing anything
+    static const byte only_end[] PROGMEM = { TLC5926_ANIM_END | TLC5926_ANIM_LOOP };
+    static const byte only_holds[] PROGMEM = {
+        TLC5926_ANIM_HOLD | TLC5926_ANIM_DURATION, 5, 0,
+        TLC5926_ANIM_HOLD,
+        TLC5926_ANIM_END | TLC5926_ANIM_LOOP
+        };
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Anim anim;
+    anim.attach(&tlc)->play(only_end);
+    CHECK(!anim.playing());
+
+    anim.play(only_holds);
+    int updates = 0;
+    for (; updates < 100 && anim.update(); updates++) delay(1);
+    CHECK(!anim.playing());
+    CHECK(updates < 100);
+    CHECK(millis() >= 10); // both holds, once
+
+    // one frame is enough to loop on
+    static const byte one_frame[] PROGMEM = {
+        TLC5926_ANIM_KEY | TLC5926_ANIM_DURATION, 5, 0, 0x83, 0x81, // 4 x 0x81
+        TLC5926_ANIM_END | TLC5926_ANIM_LOOP
+        };
+    anim.play(one_frame);
+    for (int i = 0; i < 20; i++) {
+        CHECK(anim.update());
+        delay(1);
+        }
+    CHECK_EQ(showing(chain), 0x81818181u);
+    }
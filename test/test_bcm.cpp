@@ -0,0 +1,88 @@
+// TLC5926BCM: isr() driven by hand, what each plane latches and how long it's up for
+#include "test.h"
+#include <TLC5926BCM.h>
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+
+static const byte INTENSITY[] = { 255, 0, 1, 128, 0xA5, 0x5A, 7, 200 }; // channels 0..7, and again on chip 1
+
+static unsigned int plane_word(int p) {
+    // a chip's outputs while plane p is up
+    unsigned int w = 0;
+    for (int c = 0; c < 8; c++) {
+        if (INTENSITY[c] & (1 << p)) w |= 1 << c;
+        }
+    return w;
+    }
+
+static void fill(TLC5926BCM &bcm) {
+    for (int c = 0; c < 8; c++) bcm.set(c, INTENSITY[c])->set(16 + c, INTENSITY[c]);
+    }
+
+TEST(bcm_planes_in_order) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926BCM bcm;
+    bcm.attach(&tlc);
+    fill(bcm);
+    CHECK_EQ(bcm.get(0x13), INTENSITY[3]);
+
+    CHECK(!bcm.begin(100)); // no timer here, so isr() is ours
+    CHECK_EQ(chain.outputs(0), plane_word(0));
+    CHECK_EQ(chain.shifted(0), plane_word(1)); // ready for the first interrupt
+
+    for (int p = 1; p < 8; p++) {
+        CHECK_EQ(bcm.isr(), 100u << p);
+        CHECK_EQ(chain.outputs(0), plane_word(p));
+        CHECK_EQ(chain.outputs(1), plane_word(p));
+        CHECK_EQ(chain.shifted(0), plane_word((p + 1) & 7));
+        }
+    CHECK_EQ(bcm.isr(), 100); // around again
+    CHECK_EQ(chain.outputs(0), plane_word(0));
+    CHECK_EQ(chain.setup_violations, 0);
+    bcm.end();
+    }
+
+TEST(bcm_on_time_is_the_intensity) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926BCM bcm;
+    bcm.attach(&tlc);
+    fill(bcm);
+    bcm.begin(100);
+
+    // a whole cycle: plane 0 from begin(), for the timer's first period, then each isr() for what it returns
+    unsigned long on[24] = { 0 };
+    unsigned int slot_us = 100;
+    for (int i = 0; i < 8; i++) {
+        for (int c = 0; c < 24; c++) {
+            if (chain.output(c)) on[c] += slot_us;
+            }
+        if (i < 7) slot_us = bcm.isr();
+        }
+    for (int c = 0; c < 8; c++) {
+        CHECK_EQ(on[c], INTENSITY[c] * 100UL);
+        CHECK_EQ(on[16 + c], INTENSITY[c] * 100UL);
+        }
+    CHECK_EQ(on[8], 0);
+    bcm.end();
+    }
+
+TEST(bcm_isr_ignores_defer) {
+    // the isr latches now, not when update() gets to it
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    TLC5926Step steps[4];
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926BCM bcm;
+    bcm.attach(&tlc);
+    fill(bcm);
+    bcm.begin(100);
+    tlc.defer(steps, 4);
+    bcm.isr();
+    CHECK_EQ(chain.outputs(0), plane_word(1));
+    CHECK(!tlc.busy());
+    bcm.end();
+    }
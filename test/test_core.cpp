@@ -0,0 +1,337 @@
+// TLC5926 against the chain model: what ends up in the chips, and what it took
+#include "test.h"
+#include <TLC5926.h>
+
+// all on one "port" (0-7), so the ports build takes play_steps()' one-write path
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5, SDO = 6;
+
+static byte reversed(byte v) {
+    byte r = 0;
+    for (int i = 0; i < 8; i++) r |= ((v >> i) & 1) << (7 - i);
+    return r;
+    }
+
+static void check_matches(TLC5926 &tlc, TLC5926Sim &chain) {
+    CHECK_EQ(tlc.channels(), chain.channels());
+    int wrong = 0;
+    for (int c = 0; c < chain.channels(); c++) wrong += chain.output(c) != tlc.get(c);
+    CHECK_EQ(wrong, 0);
+    }
+
+TEST(send_latches) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(1, SDI, CLK, LE, OE);
+    chain.clear_counts();
+    tlc.send(0x8001);
+    CHECK_EQ(chain.outputs(0), 0x8001);
+    CHECK_EQ(chain.clocks, 16);
+    CHECK_EQ(chain.latch_ct, 1);
+    CHECK_EQ(chain.setup_violations, 0);
+#if TLC5926_STATS
+    CHECK_EQ(tlc.stats().clocks, 16);
+    CHECK_EQ(tlc.stats().latches, 1);
+#endif
+    }
+
+TEST(send_moves_along_the_chain) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    tlc.send(0xA5A5)->send(0x0FF0);
+    CHECK_EQ(chain.outputs(0), 0x0FF0);
+    CHECK_EQ(chain.outputs(1), 0xA5A5);
+    tlc.off();
+    CHECK_EQ(chain.outputs(0), 0);
+    tlc.on();
+    CHECK_EQ(chain.outputs(0), 0x0FF0);
+    }
+
+TEST(two_wire_latches_every_clock) {
+    TLC5926Sim chain(1, SDI, CLK);
+    TLC5926 tlc;
+    tlc.attach(SDI, CLK);
+    tlc.send(0x1234);
+    CHECK_EQ(chain.outputs(0), 0x1234);
+    }
+
+TEST(all_and_send_bits) {
+    TLC5926Sim chain(3, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(3, SDI, CLK, LE, OE);
+    chain.clear_counts();
+    tlc.all(HIGH);
+    for (int i = 0; i < 3; i++) CHECK_EQ(chain.outputs(i), 0xFFFF);
+    CHECK_EQ(chain.clocks, 48);
+    tlc.all(LOW)->send_bits(4, 0x8);
+    CHECK_EQ(chain.outputs(0), 0x8);
+    CHECK_EQ(chain.outputs(1), 0);
+    }
+
+TEST(flush_frame) {
+    TLC5926Sim chain(3, SDI, CLK, LE, OE, SDO);
+    TLC5926 tlc;
+    tlc.attach(3, SDI, CLK, LE, OE, SDO);
+    tlc.set(0)->set(17)->toggle(5)->set_word(2, 0xF00F)->flush();
+    CHECK_EQ(chain.outputs(0), 0x0021);
+    CHECK_EQ(chain.outputs(1), 0x0002);
+    CHECK_EQ(chain.outputs(2), 0xF00F);
+    check_matches(tlc, chain);
+    CHECK(!tlc.dirty());
+
+    unsigned long edges = sim_edges;
+    tlc.flush(); // nothing changed
+    CHECK_EQ(sim_edges, edges);
+    tlc.set(17); // already
+    tlc.flush();
+    CHECK_EQ(sim_edges, edges);
+    }
+
+TEST(flush_mixed_widths) {
+    const byte bits[] = { 8, 16, 8 };
+    TLC5926Sim chain(3, SDI, CLK, LE, OE);
+    chain.widths(bits);
+    TLC5926 tlc;
+    tlc.attach(3, SDI, CLK, LE, OE)->chip_widths(bits, 3);
+    chain.clear_counts();
+    tlc.set(0)->set(8)->set(23)->set(31)->flush();
+    CHECK_EQ(chain.clocks, 32);
+    CHECK_EQ(chain.outputs(0), 0x01);
+    CHECK_EQ(chain.outputs(1), 0x8001);
+    CHECK_EQ(chain.outputs(2), 0x80);
+    check_matches(tlc, chain);
+    }
+
+TEST(scroll_keeps_the_frame) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    tlc.set(0)->set(15)->set(30)->flush();
+    chain.clear_counts();
+    tlc.scroll(1, HIGH);
+    CHECK_EQ(chain.clocks, 1);
+    check_matches(tlc, chain);
+    CHECK(tlc.get(0) && tlc.get(1) && tlc.get(16) && tlc.get(31));
+    tlc.scroll(12, 0xA5C);
+    check_matches(tlc, chain);
+    tlc.scroll(16, 0x8001);
+    check_matches(tlc, chain);
+    CHECK(!tlc.dirty()); // still flushed
+    unsigned long edges = sim_edges;
+    tlc.flush();
+    CHECK_EQ(sim_edges, edges);
+    }
+
+TEST(defer_runs_in_update) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    TLC5926Step steps[8];
+    tlc.attach(1, SDI, CLK, LE, OE)->defer(steps, 8);
+    tlc.send(0x00FF)->delay(100)->send(0xFF00);
+    CHECK_EQ(chain.outputs(0), 0);
+    CHECK(tlc.update());
+    CHECK_EQ(chain.outputs(0), 0x00FF);
+    ::delay(50);
+    CHECK(tlc.update());
+    CHECK_EQ(chain.outputs(0), 0x00FF);
+    ::delay(50);
+    CHECK(!tlc.update());
+    CHECK_EQ(chain.outputs(0), 0xFF00);
+    CHECK(!tlc.busy());
+    }
+
+TEST(verify_good_chain) {
+    TLC5926Sim chain(3, SDI, CLK, LE, OE, SDO);
+    TLC5926 tlc;
+    tlc.attach(3, SDI, CLK, LE, OE, SDO)->verify(true);
+    for (int i = 0; i < 6; i++) tlc.set(i * 7)->flush();
+    CHECK(tlc.verified());
+    CHECK_EQ(tlc.bit_errors(), 0);
+    check_matches(tlc, chain);
+    }
+
+TEST(verify_wrong_chain_length) {
+    TLC5926Sim chain(4, SDI, CLK, LE, OE, SDO); // one more than we say
+    TLC5926 tlc;
+    tlc.attach(3, SDI, CLK, LE, OE, SDO)->verify(true);
+    for (int i = 0; i < 6; i++) tlc.set(i * 7)->flush();
+    CHECK(!tlc.verified());
+    CHECK(tlc.bit_errors() > 0);
+    }
+
+TEST(config_per_chip) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE)->send(0x1111)->send(0x2222);
+    const byte values[] = { TLC5926::config_value(1, 0, 5), TLC5926::config_value(0, 1, 33) };
+    chain.clear_counts();
+    tlc.config(values, 2);
+    // LSB first, so the chip has it bit-reversed
+    CHECK_EQ(chain.config(0), reversed(values[0]));
+    CHECK_EQ(chain.config(1), reversed(values[1]));
+    CHECK(!chain.special());
+    CHECK_EQ(chain.mode_switches, 2);
+    CHECK_EQ(chain.latched(0), 0x2222); // pattern kept
+    CHECK_EQ(chain.latched(1), 0x1111);
+    CHECK_EQ(chain.outputs(0), 0x2222); // and still on
+    CHECK(chain.enabled());
+    CHECK_EQ(chain.setup_violations, 0);
+
+    chain.clear_counts();
+    tlc.config(values, 2); // already
+    CHECK_EQ(chain.clocks, 0);
+
+    tlc.off()->config(1, 1, 127);
+    CHECK(!chain.enabled()); // off stays off
+    }
+
+TEST(error_detect_whole_chain) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE, SDO);
+    chain.faults(0, 0x0001)->faults(1, 0x0F00);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE, SDO);
+    unsigned int status[2];
+    CHECK_EQ(tlc.error_detect(status, 2), 2);
+    CHECK_EQ(status[0], 0xFFFE);
+    CHECK_EQ(status[1], 0xF0FF);
+    CHECK_EQ(chain.status_loads, 1);
+    CHECK_EQ(chain.detect_too_soon, 0);
+    CHECK_EQ(chain.setup_violations, 0);
+    CHECK(!chain.special());
+    CHECK(chain.enabled()); // on before, on after
+
+    TLC5926Diag diag[2];
+    tlc.off()->error_detect(diag, 2);
+    CHECK_EQ(diag[1].faults, 0x0F00);
+    CHECK(!diag[1].over_temp);
+    CHECK(!chain.enabled());
+
+    tlc.on()->detect_hold();
+    tlc.detect_release();
+    CHECK(chain.enabled());
+    }
+
+TEST(error_detect_mixed_widths) {
+    const byte bits[] = { 16, 8 };
+    TLC5926Sim chain(2, SDI, CLK, LE, OE, SDO);
+    chain.widths(bits)->faults(1, 0x80);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE, SDO)->chip_widths(bits, 2);
+    unsigned int status[2];
+    tlc.error_detect(status, 2);
+    CHECK_EQ(status[0], 0xFFFF);
+    CHECK_EQ(status[1], 0x7F);
+    CHECK_EQ(tlc.error_detect(), 0x7F); // just the last chip
+    }
+
+TEST(reset_clears_and_configures) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE)->send(0xFFFF)->send(0xFFFF)->reset();
+    CHECK_EQ(chain.outputs(0), 0);
+    CHECK_EQ(chain.outputs(1), 0);
+    CHECK_EQ(chain.config(0), reversed(TLC5926::config_value(1, 1, 127)));
+    CHECK(chain.enabled());
+    CHECK(!chain.special());
+    }
+
+static void (*timer_isr)() = NULL;
+static unsigned int timer_period = 0;
+static int timer_stops = 0;
+static boolean fake_start(void (*isr)(), unsigned int period_us) {
+    timer_isr = isr;
+    timer_period = period_us;
+    return true;
+    }
+static void fake_stop() {
+    timer_isr = NULL;
+    timer_stops++;
+    }
+
+TEST(async_runs_on_the_async_timer) {
+    // what TLC5926TimerISR.h hooks up: the core only sees the two functions
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE)->async_rate(250, 1);
+    TLC5926::async_timer(fake_start, fake_stop);
+    const byte frame[] = { 0x12, 0x34, 0x56, 0x78 };
+    CHECK(tlc.send_async(frame));
+    CHECK(timer_isr != NULL);
+    CHECK_EQ(timer_period, 250);
+    int ticks = 0;
+    while (timer_isr && ticks < 10) {
+        timer_isr();
+        ticks++;
+        }
+    TLC5926::async_timer(NULL, NULL);
+    CHECK_EQ(ticks, 4);
+    CHECK_EQ(timer_stops, 1);
+    CHECK(tlc.async_done());
+    CHECK_EQ(chain.outputs(0), 0x5678);
+    CHECK_EQ(chain.outputs(1), 0x1234);
+    }
+
+TEST(async_one_chain_at_a_time) {
+    // the timer runs one TLC5926's frame: a second one is refused, not left for the isr to drop
+    TLC5926Sim b(1, 7, CLK, LE, OE);
+    TLC5926 first, second;
+    first.attach(1, SDI, CLK, LE, OE)->async_rate(100, 1);
+    second.attach(1, 7, CLK, LE, OE)->async_rate(100, 1);
+    const byte one[] = { 0x12, 0x34 }, two[] = { 0xAB, 0xCD };
+    CHECK(first.send_async(one));
+    CHECK(!second.send_async(two));
+    first.async_step();
+    first.async_step();
+    CHECK(first.async_done());
+    CHECK(second.send_async(two));
+    CHECK(!first.send_async(one));
+    second.async_step();
+    second.async_step();
+    CHECK(second.async_done());
+    CHECK_EQ(b.outputs(0), 0xABCD);
+    }
+
+TEST(destroyed_mid_async_frees_the_timer) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE);
+    const byte frame[] = { 0x0F, 0xF0 };
+    TLC5926::async_timer(fake_start, fake_stop);
+    timer_stops = 0;
+    {
+        TLC5926 gone;
+        gone.attach(1, SDI, CLK, LE, OE)->async_rate(100, 1);
+        gone.set(3)->frame(); // a framebuffer and a shadow to free
+        CHECK(gone.send_async(frame));
+        }
+    CHECK(timer_isr == NULL);
+    CHECK_EQ(timer_stops, 1);
+    TLC5926 next;
+    next.attach(1, SDI, CLK, LE, OE)->async_rate(100, 1);
+    CHECK(next.send_async(frame)); // not refused for the one that's gone
+    while (timer_isr) timer_isr();
+    TLC5926::async_timer(NULL, NULL);
+    CHECK_EQ(chain.outputs(0), 0x0FF0);
+    }
+
+TEST(async_without_a_timer) {
+    // nothing calls async_step(): whatever waits on the frame shifts it, instead of spinning forever
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE)->async_rate(100, 1);
+    const byte frame[] = { 0x12, 0x34, 0x56, 0x78 };
+    CHECK(tlc.send_async(frame));
+    tlc.send(0xBEEF); // waits for the frame, then shifts its word
+    CHECK_EQ(chain.latch_ct, 2);
+    CHECK_EQ(chain.outputs(0), 0xBEEF);
+    CHECK_EQ(chain.outputs(1), 0x5678);
+
+    // the README's loop
+    tlc.set_word(0, 0x0F0F)->set_word(1, 0xF0F0);
+    CHECK(tlc.flush_async());
+    tlc.set(4);
+    int polls = 0;
+    while (!tlc.async_done() && polls < 100) polls++;
+    CHECK(polls < 100);
+    CHECK_EQ(chain.outputs(0), 0x0F0F);
+    CHECK_EQ(chain.outputs(1), 0xF0F0);
+    CHECK(tlc.dirty()); // set(4) came after
+    }
@@ -0,0 +1,86 @@
+// TLC5926Dimmer: what it leaves in the pwm (analogWrite, or Timer1's registers) for a level
+#include "test.h"
+#include <TLC5926Dimmer.h>
+#include <TLC5926Timer.h>
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+static const int OE_T1 = 9; // OC1A, like an Uno
+
+TEST(dimmer_8bit_dithers_to_12) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(1, SDI, CLK, LE, OE);
+    TLC5926Dimmer dimmer;
+    dimmer.attach(&tlc)->level(255);
+    CHECK_EQ(sim_pwm(OE), -1); // all the way: plain digital
+    CHECK(chain.enabled());
+    dimmer.level(0);
+    CHECK(!chain.enabled());
+
+    // 16 ticks of 8-bit duty add up to the 12-bit one
+    dimmer.level(128);
+    unsigned int duty = 0;
+    for (int i = 0; i < 16; i++) {
+        dimmer.tick();
+        CHECK(sim_pwm(OE) > 0);
+        duty += 255 - sim_pwm(OE); // inverted
+        }
+    CHECK_EQ(duty, TLC5926Dimmer::gamma(128));
+    CHECK_EQ(TCCR1A, 0); // not on Timer1
+    }
+
+TEST(dimmer_wide_registers) {
+    sim_pin_timer(OE_T1, TIMER1A);
+    TLC5926Sim chain(1, SDI, CLK, LE, OE_T1);
+    TLC5926 tlc;
+    tlc.attach(1, SDI, CLK, LE, OE_T1);
+    TLC5926Dimmer dimmer;
+    dimmer.attach(&tlc)->level(255);
+    // fast pwm to ICR1, no prescale, OC1A non-inverting
+    CHECK_EQ(TCCR1A, _BV(WGM11) | _BV(COM1A1));
+    CHECK_EQ(TCCR1B, _BV(WGM13) | _BV(WGM12) | _BV(CS10));
+    CHECK_EQ(ICR1, 4095);
+    CHECK_EQ(OCR1A, 0); // /OE high for none of it
+    dimmer.level(0);
+    CHECK_EQ(OCR1A, 4095);
+    dimmer.level(128);
+    CHECK_EQ(OCR1A, 4095 - TLC5926Dimmer::gamma(128));
+    CHECK(TLC5926Timer::reserved());
+    CHECK(!TLC5926Timer::start(TLC5926Dimmer::timer_isr, 100));
+    }
+
+TEST(dimmer_wide_gives_oe_back) {
+    // digitalWrite() only clears COM1A1: with nothing else set, the pin is the port's again
+    sim_pin_timer(OE_T1, TIMER1A);
+    TLC5926Sim chain(1, SDI, CLK, LE, OE_T1);
+    TLC5926 tlc;
+    tlc.attach(1, SDI, CLK, LE, OE_T1);
+    TLC5926Dimmer dimmer;
+    dimmer.attach(&tlc)->level(100);
+    tlc.off();
+    CHECK_EQ(TCCR1A & (_BV(COM1A1) | _BV(COM1A0)), 0);
+    CHECK(!chain.enabled());
+    dimmer.level(100); // and back
+    CHECK_EQ(TCCR1A, _BV(WGM11) | _BV(COM1A1));
+    CHECK_EQ(OCR1A, 4095 - TLC5926Dimmer::gamma(100));
+    }
+
+TEST(dimmer_wide_fade) {
+    // no overflow vector here, so tick() is ours at 1kHz
+    sim_pin_timer(OE_T1, TIMER1A);
+    TLC5926Sim chain(1, SDI, CLK, LE, OE_T1);
+    TLC5926 tlc;
+    tlc.attach(1, SDI, CLK, LE, OE_T1);
+    TLC5926Dimmer dimmer;
+    dimmer.attach(&tlc)->level(0)->fade(255, 10);
+    CHECK(dimmer.fading());
+    unsigned int was = OCR1A;
+    for (int i = 0; i < 10; i++) {
+        dimmer.tick();
+        CHECK(OCR1A < was); // brighter each tick
+        was = OCR1A;
+        }
+    CHECK(!dimmer.fading());
+    CHECK_EQ(dimmer.level(), 255);
+    CHECK_EQ(OCR1A, 0);
+    }
@@ -0,0 +1,93 @@
+// TLC5926Fixed<> makes the same edges as TLC5926, in the same order
+#include "test.h"
+#include <TLC5926.h>
+#include <TLC5926Fixed.h>
+
+typedef std::vector<SimEdge> Edges;
+
+static boolean same_edges(const Edges &a, const Edges &b) {
+    // pins and levels, not times: the point of Fixed is to be quicker
+    if (a.size() != b.size()) {
+        printf("  %d edges vs %d\n", (int) a.size(), (int) b.size());
+        return false;
+        }
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].pin != b[i].pin || a[i].level != b[i].level) {
+            printf("  edge %d: pin %d->%d vs pin %d->%d\n", (int) i, a[i].pin, a[i].level, b[i].pin, b[i].level);
+            return false;
+            }
+        }
+    return true;
+    }
+
+template <class T> static void script(T &tlc) {
+    tlc.send(0xA5F0)->send(0x0001);
+    tlc.all(HIGH)->all(LOW);
+    tlc.send_bits(5, 0x13);
+    tlc.off()->on();
+    tlc.shift(0x8000);
+    tlc.latch_pulse();
+    tlc.normal_mode();
+    tlc.send(0x7E7E);
+    }
+
+template <int SDI, int CLK, int LE, int OE> static void compare() {
+    Edges dynamic, fixed;
+    unsigned long dynamic_writes;
+    unsigned int dynamic_out[2];
+    {
+        TLC5926Sim chain(2, SDI, CLK, LE, OE);
+        TLC5926 tlc;
+        sim_trace(true);
+        tlc.attach(2, SDI, CLK, LE, OE);
+        script(tlc);
+        dynamic = sim_traced();
+        dynamic_writes = sim_writes;
+        dynamic_out[0] = chain.latched(0);
+        dynamic_out[1] = chain.latched(1);
+        CHECK_EQ(chain.setup_violations, 0);
+        }
+    sim_reset();
+    {
+        TLC5926Sim chain(2, SDI, CLK, LE, OE);
+        TLC5926Fixed<SDI, CLK, LE, OE> tlc;
+        sim_trace(true);
+        tlc.attach(2);
+        script(tlc);
+        fixed = sim_traced();
+        CHECK_EQ(chain.latched(0), dynamic_out[0]);
+        CHECK_EQ(chain.latched(1), dynamic_out[1]);
+        CHECK_EQ(chain.latched(0), 0x7E7E); // (normal_mode() leaves /OE high)
+        CHECK_EQ(chain.setup_violations, 0);
+        CHECK(sim_writes <= dynamic_writes);
+        }
+    CHECK(same_edges(dynamic, fixed));
+    CHECK(fixed.size() > 100);
+    }
+
+TEST(fixed_same_edges_one_port) {
+    compare<2, 3, 4, 5>();
+    }
+
+TEST(fixed_same_edges_split_ports) {
+    compare<2, 11, 20, 29>();
+    }
+
+TEST(fixed_two_wire) {
+    Edges dynamic;
+    {
+        TLC5926Sim chain(1, 6, 7);
+        TLC5926 tlc;
+        sim_trace(true);
+        tlc.attach(6, 7);
+        tlc.send(0x1234)->all(HIGH)->send_bits(3, 0x2);
+        dynamic = sim_traced();
+        }
+    sim_reset();
+    TLC5926Sim chain(1, 6, 7);
+    TLC5926Fixed<6, 7> tlc;
+    sim_trace(true);
+    tlc.attach(1)->send(0x1234)->all(HIGH)->send_bits(3, 0x2);
+    CHECK(same_edges(dynamic, sim_traced()));
+    CHECK_EQ(chain.outputs(0), 0xFFFA);
+    }
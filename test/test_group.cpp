@@ -0,0 +1,87 @@
+// TLC5926Group: chains of different lengths on one CLK, in one pass: what they get, what it took
+#include "test.h"
+#include <TLC5926Group.h>
+
+static const int CLK = 8, LE = 9, OE = 10; // SDI's on 2 and 3
+
+TEST(group_flush_one_pass) {
+    TLC5926Sim left_chain(4, 2, CLK, LE, OE), right_chain(2, 3, CLK, LE, OE);
+    TLC5926 left, right;
+    left.attach(4, 2, CLK, LE, OE);
+    right.attach(2, 3, CLK, LE, OE);
+    TLC5926Group panels;
+    panels.add(&left)->add(&right);
+    CHECK_EQ(panels.size(), 2);
+    left.set_word(0, 0x1234)->set_word(3, 0x8001);
+    right.set_word(1, 0xF00F);
+
+    left_chain.clear_counts();
+    right_chain.clear_counts();
+    unsigned long edges = sim_edges;
+    unsigned long long took = sim_ns;
+    panels.flush();
+    edges = sim_edges - edges;
+    took = sim_ns - took;
+
+    CHECK_EQ(left_chain.outputs(0), 0x1234);
+    CHECK_EQ(left_chain.outputs(3), 0x8001);
+    CHECK_EQ(right_chain.outputs(0), 0);
+    CHECK_EQ(right_chain.outputs(1), 0xF00F);
+    // the longest chain's clocks, once: the short one's padding fell off its end
+    CHECK_EQ(left_chain.clocks, 64);
+    CHECK_EQ(right_chain.clocks, 64);
+    CHECK_EQ(left_chain.latch_ct, 1);
+    CHECK_EQ(right_chain.latch_ct, 1);
+    CHECK_EQ(left_chain.setup_violations, 0);
+    CHECK_EQ(right_chain.setup_violations, 0);
+    CHECK(!left.dirty() && !right.dirty());
+    // 64 CLK pulses and one LE pulse, at most; the SDI's only move when their bit does
+    CHECK(edges >= 2 * 64 + 2);
+    CHECK(edges <= 2 * 64 + 2 + 2 * 64);
+
+#if TLC5926_STATS
+    TLC5926Stats l = left.stats(), r = right.stats();
+    CHECK_EQ(l.clocks, 64);
+    CHECK_EQ(r.clocks, 64);
+    CHECK_EQ(l.bytes, 8);
+    CHECK_EQ(r.bytes, 8);
+    CHECK_EQ(l.latches, 1);
+    CHECK_EQ(r.latches, 1);
+#endif
+
+    // nothing changed: nothing on the pins
+    edges = sim_edges;
+    panels.flush();
+    CHECK_EQ(sim_edges - edges, 0);
+
+    // each on its own: 64 clocks and then 32 more
+    left.set(1);
+    right.set(1);
+    unsigned long long alone = sim_ns;
+    left.flush();
+    right.flush();
+    alone = sim_ns - alone;
+    CHECK(took < alone);
+    }
+
+TEST(group_separate_latches) {
+    TLC5926Sim a(1, 2, CLK, LE, OE), b(1, 3, CLK, 11, OE);
+    TLC5926 first, second;
+    first.attach(1, 2, CLK, LE, OE);
+    second.attach(1, 3, CLK, 11, OE);
+    TLC5926Group group;
+    group.add(&first)->add(&second);
+    first.set_word(0, 0xA5A5);
+    second.set_word(0, 0x0FF0);
+    a.clear_counts();
+    b.clear_counts();
+    group.flush();
+    CHECK_EQ(a.outputs(0), 0xA5A5);
+    CHECK_EQ(b.outputs(0), 0x0FF0);
+    CHECK_EQ(a.latch_ct, 1);
+    CHECK_EQ(b.latch_ct, 1);
+    group.off();
+    CHECK(!a.enabled() && !b.enabled());
+    group.on();
+    CHECK(a.enabled() && b.enabled());
+    }
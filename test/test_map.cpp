@@ -0,0 +1,182 @@
+// channel_map(): random maps, mirrored chips and mixed widths against the obvious bit-at-a-time remap,
+// for every way a whole frame gets to the chain. And the maps it has to turn down.
+#include "test.h"
+#include <TLC5926Receiver.h>
+#include "MemoryStream.h"
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+static const int CHIPS = 3;
+
+static uint32_t random_state = 2463534242u;
+static uint32_t random_next() {
+    // xorshift: the same every run
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+    }
+
+static void shuffle(byte *values, int ct) {
+    for (int i = ct - 1; i > 0; i--) {
+        int j = random_next() % (i + 1);
+        byte v = values[i];
+        values[i] = values[j];
+        values[j] = v;
+        }
+    }
+
+static unsigned int naive(unsigned int word, const byte *map, boolean mirror, int width) {
+    // logical channel i is OUT map[i], counted from the other end if the chip's backwards
+    unsigned int out = 0;
+    for (int i = 0; i < width; i++) {
+        if ((word >> i) & 1) out |= 1u << (mirror ? width - 1 - map[i] : map[i]);
+        }
+    return out;
+    }
+
+struct Board {
+    byte widths[CHIPS];
+    byte map[16];
+    boolean mirrored[CHIPS];
+
+    void randomize() {
+        boolean any8 = false;
+        for (int c = 0; c < CHIPS; c++) {
+            widths[c] = random_next() & 1 ? 8 : 16;
+            mirrored[c] = random_next() & 1;
+            any8 |= widths[c] == 8;
+            }
+        for (int i = 0; i < 16; i++) map[i] = i;
+        if (any8) {
+            shuffle(map, 8); // a TLC5916's 8 have to stay in its 8
+            shuffle(map + 8, 8);
+            }
+        else shuffle(map, 16);
+        }
+
+    void attach(TLC5926 &tlc, TLC5926Sim &chain, boolean le) {
+        chain.widths(widths);
+        if (le) tlc.attach(CHIPS, SDI, CLK, LE, OE);
+        else tlc.attach(CHIPS, SDI, CLK);
+        tlc.chip_widths(widths, CHIPS)->channel_map(map, mirrored, CHIPS);
+        }
+
+    // outputs(chip) == the naive remap of each chip's logical word
+    int wrong(TLC5926 &tlc, TLC5926Sim &chain) {
+        int ct = 0;
+        for (int c = 0; c < CHIPS; c++) {
+            unsigned int word = 0;
+            for (int i = 0; i < widths[c]; i++) word |= (unsigned int) tlc.get(tlc.chip_channel(c) + i) << i;
+            ct += chain.outputs(c) != naive(word, map, mirrored[c], widths[c]);
+            }
+        return ct;
+        }
+    };
+
+static void random_frame(TLC5926 &tlc, byte *frame) {
+    for (int i = 0; i < tlc.frame_bytes(); i++) frame[i] = random_next() >> 24;
+    tlc.set_bytes(0, frame, tlc.frame_bytes());
+    }
+
+TEST(map_flush_matches_naive) {
+    int wrong = 0;
+    for (int n = 0; n < 200; n++) {
+        Board board;
+        board.randomize();
+        sim_reset();
+        TLC5926Sim chain(CHIPS, SDI, CLK, LE, OE);
+        TLC5926 tlc;
+        board.attach(tlc, chain, true);
+        byte frame[2 * CHIPS];
+        random_frame(tlc, frame);
+        tlc.flush();
+        wrong += board.wrong(tlc, chain);
+        }
+    CHECK_EQ(wrong, 0);
+    }
+
+TEST(map_async_matches_naive) {
+    int wrong = 0;
+    for (int n = 0; n < 50; n++) {
+        Board board;
+        board.randomize();
+        sim_reset();
+        TLC5926Sim chain(CHIPS, SDI, CLK, LE, OE);
+        TLC5926 tlc;
+        board.attach(tlc, chain, true);
+        byte frame[2 * CHIPS];
+        random_frame(tlc, frame);
+        CHECK(tlc.flush_async());
+        while (!tlc.async_done()) tlc.async_step();
+        wrong += board.wrong(tlc, chain);
+        }
+    CHECK_EQ(wrong, 0);
+    }
+
+TEST(map_receiver_matches_naive) {
+    // the Receiver's frames are logical, like frame(): with LE (a chip at a time) and without (flush())
+    int wrong = 0;
+    for (int n = 0; n < 100; n++) {
+        boolean le = n & 1;
+        Board board;
+        board.randomize();
+        sim_reset();
+        TLC5926Sim chain(CHIPS, SDI, CLK, le ? LE : -1, le ? OE : -1);
+        TLC5926 tlc, expect;
+        board.attach(tlc, chain, le);
+        expect.attach(CHIPS, 40, 41)->chip_widths(board.widths, CHIPS); // just for its get()
+        byte frame[2 * CHIPS];
+        random_frame(expect, frame);
+
+        int len = tlc.frame_bytes();
+        byte sum = len;
+        MemoryStream stream;
+        stream.write(0xA5);
+        stream.write(0x5A);
+        stream.write(len);
+        stream.write(0);
+        for (int i = 0; i < len; i++) {
+            stream.write(frame[i]);
+            sum += frame[i];
+            }
+        stream.write(-sum);
+        TLC5926Receiver rx;
+        rx.attach(&tlc, stream);
+        CHECK(rx.poll());
+        wrong += board.wrong(expect, chain);
+        }
+    CHECK_EQ(wrong, 0);
+    }
+
+TEST(map_refuses_non_permutations) {
+    const byte widths[] = { 16, 8, 16 };
+    byte map[16];
+    for (int i = 0; i < 16; i++) map[i] = 15 - i; // fine for 16 bit chips, not for a TLC5916
+    TLC5926Sim chain(CHIPS, SDI, CLK, LE, OE);
+    chain.widths(widths);
+    TLC5926 tlc;
+    tlc.attach(CHIPS, SDI, CLK, LE, OE)->chip_widths(widths, CHIPS)->channel_map(map);
+    tlc.set(0)->flush();
+    CHECK_EQ(chain.outputs(0), 0x0001); // straight through
+
+    // a map from before chip_widths() is dropped too
+    TLC5926 later;
+    later.attach(CHIPS, SDI, CLK, LE, OE)->channel_map(map)->chip_widths(widths, CHIPS);
+    later.set(1)->flush();
+    CHECK_EQ(chain.outputs(0), 0x0002);
+
+    // an output twice (and so one never)
+    map[0] = map[1];
+    TLC5926 twice;
+    twice.attach(CHIPS, SDI, CLK, LE, OE)->channel_map(map);
+    twice.set(2)->flush();
+    CHECK_EQ(chain.outputs(0), 0x0004);
+
+    // 0..7 in the first 8 is fine with a TLC5916
+    for (int i = 0; i < 16; i++) map[i] = i < 8 ? 7 - i : i;
+    TLC5926 ok;
+    ok.attach(CHIPS, SDI, CLK, LE, OE)->chip_widths(widths, CHIPS)->channel_map(map);
+    ok.set(0)->set(16)->flush();
+    CHECK_EQ(chain.outputs(0), 0x0080);
+    CHECK_EQ(chain.outputs(1), 0x80);
+    }
@@ -0,0 +1,78 @@
+// TLC5926Matrix: isr() driven by hand, which row is on, with what columns, for how long
+#include "test.h"
+#include <TLC5926Matrix.h>
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+static const int ROWS[] = { 16, 17, 18, 19 };
+
+static int row_lit() {
+    // the one row that's on, -1 if none, -2 if more
+    int lit = -1;
+    for (int r = 0; r < 4; r++) {
+        if (sim_pin(ROWS[r])) lit = lit == -1 ? r : -2;
+        }
+    return lit;
+    }
+
+TEST(matrix_rows_in_turn) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Matrix matrix;
+    matrix.attach(&tlc, ROWS, 4);
+    CHECK_EQ(matrix.columns(), 32);
+    for (int r = 0; r < 4; r++) matrix.set(r, r)->set(r, 31 - r);
+    CHECK_EQ(matrix.get(2, 29), 1);
+
+    CHECK(!matrix.begin(100)); // no timer here, so isr() is ours. 4 rows at 100Hz: 2500us each
+    CHECK(!chain.enabled());
+    CHECK_EQ(row_lit(), -1);
+
+    for (int i = 0; i < 8; i++) {
+        int r = i % 4;
+        CHECK_EQ(matrix.isr(), 2500);
+        CHECK_EQ(row_lit(), r);
+        CHECK(chain.enabled());
+        CHECK_EQ(chain.outputs(0), 1u << r);
+        CHECK_EQ(chain.outputs(1), 0x8000u >> r);
+        }
+    CHECK_EQ(matrix.frames(), 2);
+    CHECK_EQ(chain.setup_violations, 0);
+
+    matrix.end();
+    CHECK(!chain.enabled());
+    CHECK_EQ(row_lit(), -1);
+    }
+
+TEST(matrix_planes_are_weighted) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(1, SDI, CLK, LE, OE);
+    TLC5926Matrix matrix;
+    matrix.attach(&tlc, ROWS, 4, 2); // 0..3 per pixel
+    for (int c = 0; c < 4; c++) matrix.set(1, c, c); // row 1 has all four
+    matrix.set(3, 15, 3);
+    CHECK(!matrix.begin(50)); // 4 rows x (1 + 2) slots at 50Hz: 1666us base
+
+    // row r, plane p: for base << p, showing the pixels with bit p
+    unsigned long on[16] = { 0 }, row_us[4] = { 0 };
+    for (int slot = 0; slot < 8; slot++) {
+        int p = slot % 2;
+        unsigned int us = matrix.isr();
+        CHECK_EQ(us, 1666u << p);
+        CHECK_EQ(row_lit(), slot / 2);
+        row_us[slot / 2] += us;
+        if (slot / 2 == 1) {
+            for (int c = 0; c < 16; c++) {
+                if (chain.output(c)) on[c] += us;
+                }
+            }
+        if (slot / 2 == 3) CHECK_EQ(chain.outputs(0), 0x8000);
+        if (slot / 2 == 0) CHECK_EQ(chain.outputs(0), 0);
+        }
+    for (int c = 0; c < 4; c++) CHECK_EQ(on[c], c * 1666UL);
+    CHECK_EQ(on[4], 0);
+    for (int r = 0; r < 4; r++) CHECK_EQ(row_us[r], 3 * 1666UL); // every row gets the same
+    CHECK_EQ(matrix.frames(), 1);
+    matrix.end();
+    }
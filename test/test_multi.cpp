@@ -0,0 +1,70 @@
+// TLC5926Multi: transpose8() against the obvious loop, and several chains off one clock
+#include "test.h"
+#include <TLC5926Multi.h>
+
+static const int CLK = 8, LE = 9, OE = 10; // SDI's on 0-7, one port
+
+static void naive_transpose8(const byte in[8], byte out[8]) {
+    for (int k = 0; k < 8; k++) {
+        out[k] = 0;
+        for (int b = 0; b < 8; b++) out[k] |= ((in[b] >> (7 - k)) & 1) << b;
+        }
+    }
+
+static uint32_t random_state = 12345;
+static byte random_byte() {
+    // xorshift: the same every run
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state >> 24;
+    }
+
+TEST(transpose8_matches_naive) {
+    byte in[8], got[8], want[8];
+    int wrong = 0;
+    for (int n = 0; n < 100000; n++) {
+        for (int i = 0; i < 8; i++) in[i] = random_byte();
+        TLC5926Multi::transpose8(in, got);
+        naive_transpose8(in, want);
+        wrong += memcmp(got, want, 8) != 0;
+        }
+    CHECK_EQ(wrong, 0);
+    }
+
+TEST(transpose8_single_bits) {
+    // every one of the 64 bits lands in its place, alone
+    byte in[8], out[8];
+    for (int b = 0; b < 8; b++) {
+        for (int bit = 0; bit < 8; bit++) {
+            memset(in, 0, 8);
+            in[b] = 1 << bit;
+            TLC5926Multi::transpose8(in, out);
+            for (int k = 0; k < 8; k++) CHECK_EQ(out[k], k == 7 - bit ? 1 << b : 0);
+            }
+        }
+    }
+
+TEST(multi_chains_get_their_frames) {
+    const int pins[] = { 1, 4, 6 };
+    byte frames[3][4] = { { 0x12, 0x34, 0x56, 0x78 }, { 0xFF, 0x00, 0x80, 0x01 }, { 0xA5, 0x5A, 0xC3, 0x3C } };
+    TLC5926Sim a(2, pins[0], CLK, LE, OE), b(2, pins[1], CLK, LE, OE), c(2, pins[2], CLK, LE, OE);
+    TLC5926Sim *chains[] = { &a, &b, &c };
+    TLC5926Multi multi;
+    multi.attach(2, CLK, LE, OE);
+    for (int i = 0; i < 3; i++) multi.add_chain(pins[i], frames[i]);
+    multi.send();
+    for (int i = 0; i < 3; i++) {
+        CHECK_EQ(chains[i]->outputs(0), (frames[i][2] << 8) | frames[i][3]);
+        CHECK_EQ(chains[i]->outputs(1), (frames[i][0] << 8) | frames[i][1]);
+        CHECK_EQ(chains[i]->clocks, 32);
+        CHECK_EQ(chains[i]->latch_ct, 1);
+        CHECK_EQ(chains[i]->setup_violations, 0);
+        }
+
+    frames[1][3] = 0x02; // not copied
+    multi.off();
+    CHECK_EQ(b.outputs(0), 0);
+    multi.on()->send();
+    CHECK_EQ(b.outputs(0), 0x8002);
+    }
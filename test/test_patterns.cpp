@@ -0,0 +1,73 @@
+// TLC5926Patterns.h: the compile-time tables, bit by bit against the patterns, and what show() puts on a chain
+#include "test.h"
+#include <TLC5926Patterns.h>
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+
+template <class P>
+static int table_wrong() {
+    // frame f's byte b (frame() order) has channels (bytes - 1 - b) * 8 .. +7
+    typedef TLC5926Table<P> T;
+    int wrong = 0;
+    for (unsigned f = 0; f < T::frames; f++) {
+        for (unsigned c = 0; c < T::channels; c++) {
+            byte b = pgm_read_byte(T::data + f * T::bytes + T::bytes - 1 - c / 8);
+            wrong += ((b >> (c % 8)) & 1) != P::on(f, c);
+            }
+        }
+    return wrong;
+    }
+
+struct Snake { static constexpr unsigned logical(unsigned c) { return (c / 8) % 2 ? c ^ 7 : c; } };
+
+TEST(patterns_frames) {
+    CHECK_EQ(TLC5926Chase<32>::frames, 32);
+    CHECK_EQ(TLC5926Bounce<32>::frames, 62);
+    CHECK_EQ(TLC5926Bounce<1>::frames, 1);
+    CHECK_EQ(TLC5926Fill<16>::frames, 17);
+    CHECK_EQ(TLC5926Table<TLC5926Bounce<32> >::bytes, 4);
+    CHECK_EQ(sizeof(TLC5926Table<TLC5926Bounce<32> >::data), 62 * 4);
+
+    CHECK(TLC5926Bounce<8>::on(7, 7));
+    CHECK(TLC5926Bounce<8>::on(8, 6)); // on the way back
+    CHECK(TLC5926Fill<8>::on(3, 2) && !TLC5926Fill<8>::on(3, 3));
+    CHECK(TLC5926Mirror<TLC5926Chase<16> >::on(0, 15));
+    CHECK(TLC5926Reversed<TLC5926Chase<32> >::on(1, 14)); // chip 0 backwards
+    CHECK(TLC5926Reversed<TLC5926Chase<32> >::on(16, 31)); // and chip 1
+    typedef TLC5926Reversed<TLC5926Chase<16>, 8> chase_8bit_chips;
+    typedef TLC5926Remapped<TLC5926Chase<16>, Snake> snake;
+    CHECK(chase_8bit_chips::on(8, 15));
+    CHECK(snake::on(8, 15));
+    }
+
+TEST(patterns_tables_match) {
+    CHECK_EQ(table_wrong<TLC5926Chase<32> >(), 0);
+    CHECK_EQ(table_wrong<TLC5926Bounce<24> >(), 0);
+    CHECK_EQ(table_wrong<TLC5926Fill<48> >(), 0);
+    CHECK_EQ(table_wrong<TLC5926Mirror<TLC5926Fill<32> > >(), 0);
+    CHECK_EQ(table_wrong<TLC5926Reversed<TLC5926Chase<32> > >(), 0);
+    typedef TLC5926Reversed<TLC5926Bounce<16>, 8> bounce_8bit_chips;
+    typedef TLC5926Remapped<TLC5926Chase<32>, Snake> snake;
+    CHECK_EQ(table_wrong<bounce_8bit_chips>(), 0);
+    CHECK_EQ(table_wrong<snake>(), 0);
+    CHECK_EQ(table_wrong<TLC5926Chase<256> >(), 0); // deep enough to need the log(N) indices
+    }
+
+TEST(patterns_show) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    typedef TLC5926Table<TLC5926Bounce<32> > bounce;
+    for (unsigned f = 0; f < bounce::frames; f++) {
+        bounce::show(&tlc, f);
+        int lit = f < 32 ? f : 62 - f;
+        CHECK_EQ(chain.outputs(lit / 16), 1u << (lit % 16));
+        CHECK_EQ(chain.outputs(1 - lit / 16), 0);
+        }
+
+    // narrower than the chain: the first channels, the rest left alone
+    tlc.set(20)->flush();
+    TLC5926Table<TLC5926Fill<16> >::show(&tlc, 16);
+    CHECK_EQ(chain.outputs(0), 0xFFFF);
+    CHECK_EQ(chain.outputs(1), 0x0010);
+    }
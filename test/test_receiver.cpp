@@ -0,0 +1,126 @@
+// TLC5926Receiver: what extras/send_frames.py sends for anim_frames.txt (build/rx_frames.bin), through a
+// MemoryStream a few bytes at a time, into the chain. And bad frames, which must never show.
+#include "test.h"
+#include <TLC5926Receiver.h>
+#include "MemoryStream.h"
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5;
+
+static std::vector<uint32_t> want_frames() {
+    // anim_frames.txt: chip 1's outputs, then chip 0's (the frame bytes in order)
+    std::vector<uint32_t> frames;
+    FILE *f = fopen("anim_frames.txt", "r");
+    char line[200];
+    while (f && fgets(line, sizeof(line), f)) {
+        char *comment = strchr(line, '#');
+        if (comment) *comment = 0;
+        unsigned long ms;
+        unsigned int high, low;
+        if (sscanf(line, "%lu %x %x", &ms, &high, &low) == 3) frames.push_back((uint32_t) high << 16 | low);
+        }
+    if (f) fclose(f);
+    return frames;
+    }
+
+static std::vector<uint8_t> sent_bytes() {
+    std::vector<uint8_t> bytes;
+    FILE *f = fopen("build/rx_frames.bin", "rb");
+    int c;
+    while (f && (c = fgetc(f)) != EOF) bytes.push_back(c);
+    if (f) fclose(f);
+    return bytes;
+    }
+
+static uint32_t showing(TLC5926Sim &chain) {
+    return (uint32_t) chain.outputs(1) << 16 | chain.outputs(0);
+    }
+
+// poll() after every few bytes: what was up each time a frame went up
+static std::vector<uint32_t> receive(TLC5926Receiver &rx, TLC5926Sim &chain, MemoryStream &stream, int chunk) {
+    std::vector<uint32_t> seen;
+    while (!stream.drained()) {
+        stream.release(chunk);
+        if (rx.poll()) seen.push_back(showing(chain));
+        }
+    return seen;
+    }
+
+TEST(receiver_takes_send_frames_output) {
+    std::vector<uint32_t> want = want_frames();
+    std::vector<uint8_t> bytes = sent_bytes();
+    CHECK_EQ(want.size(), 8);
+    CHECK_EQ(bytes.size(), want.size() * (2 + 2 + 4 + 1));
+    MemoryStream stream(bytes.data(), bytes.size());
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Receiver rx;
+    rx.attach(&tlc, stream);
+    chain.clear_counts();
+    CHECK(want == receive(rx, chain, stream, 3));
+    CHECK_EQ(rx.frames(), want.size());
+    CHECK_EQ(rx.errors(), 0);
+    CHECK_EQ(chain.latch_ct, want.size()); // one each, only when the checksum is in
+    CHECK_EQ(chain.clocks, want.size() * 32); // shifted as it came, nothing else
+    }
+
+TEST(receiver_partial_frame_doesnt_show) {
+    std::vector<uint8_t> bytes = sent_bytes();
+    MemoryStream stream(bytes.data(), bytes.size());
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Receiver rx;
+    rx.attach(&tlc, stream);
+    stream.release(8); // all but the checksum
+    CHECK(!rx.poll());
+    CHECK_EQ(chain.latch_ct, 0);
+    CHECK_EQ(chain.shifted(0), 0xF0F0); // it's in the registers, though
+    stream.release(1);
+    CHECK(rx.poll());
+    CHECK_EQ(showing(chain), 0x0F0FF0F0u);
+    }
+
+TEST(receiver_bad_frames_never_show) {
+    std::vector<uint32_t> want = want_frames();
+    std::vector<uint8_t> bytes = sent_bytes();
+    bytes[9 + 5] ^= 0x01; // the second frame's payload
+    bytes[2 * 9 + 2] = 3; // the third's length
+    static const uint8_t noise[] = { 0x00, 0xA5, 0x00, 0x5A, 0xA5 };
+    bytes.insert(bytes.begin(), noise, noise + sizeof(noise)); // before the first sync
+    MemoryStream stream(bytes.data(), bytes.size());
+    TLC5926Sim chain(2, SDI, CLK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE);
+    TLC5926Receiver rx;
+    rx.attach(&tlc, stream);
+    std::vector<uint32_t> seen = receive(rx, chain, stream, 1);
+    want.erase(want.begin() + 1, want.begin() + 3);
+    CHECK(want == seen);
+    CHECK_EQ(rx.frames(), 6);
+    CHECK_EQ(rx.errors(), 2);
+    }
+
+TEST(receiver_without_le) {
+    // 2-wire: every clock shows, so it goes through the framebuffer and is flush()'d when good
+    std::vector<uint32_t> want = want_frames();
+    std::vector<uint8_t> bytes = sent_bytes();
+    MemoryStream stream(bytes.data(), bytes.size());
+    TLC5926Sim chain(2, SDI, CLK);
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK);
+    TLC5926Receiver rx;
+    rx.attach(&tlc, stream);
+    std::vector<uint32_t> seen;
+    while (!stream.drained()) {
+        uint32_t was = showing(chain);
+        unsigned long clocks = chain.clocks;
+        stream.release(1);
+        if (rx.poll()) seen.push_back(showing(chain));
+        else {
+            CHECK_EQ(showing(chain), was);
+            CHECK_EQ(chain.clocks, clocks);
+            }
+        }
+    CHECK(want == seen);
+    }
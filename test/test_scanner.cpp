@@ -0,0 +1,77 @@
+// TLC5926Scanner: isr() driven by hand, switches opened and closed on the chain model (faults() is open)
+#include "test.h"
+#include <TLC5926Scanner.h>
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5, SDO = 6;
+
+static void samples(TLC5926Scanner &inputs, int ct) {
+    for (int i = 0; i < ct; i++) inputs.isr();
+    }
+
+TEST(scanner_debounces_4_samples) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE, SDO);
+    chain.faults(0, 0xFFFF)->faults(1, 0xFFFF); // every switch open
+    TLC5926 tlc;
+    tlc.attach(2, SDI, CLK, LE, OE, SDO);
+    TLC5926Scanner inputs;
+    inputs.attach(&tlc);
+    CHECK(!inputs.begin()); // no timer here, so isr() is ours
+    CHECK(chain.special());
+    CHECK_EQ(inputs.state(0), 0);
+    CHECK_EQ(inputs.next_change(), -1); // begin() starts from what's there
+
+    // closed: the 4th sample in a row takes it
+    chain.faults(0, 0xFFF7)->faults(1, 0x7FFF);
+    samples(inputs, 3);
+    CHECK_EQ(inputs.get(3), 0);
+    CHECK_EQ(inputs.get(31), 0);
+    samples(inputs, 1);
+    CHECK_EQ(inputs.get(3), 1);
+    CHECK_EQ(inputs.get(31), 1);
+    CHECK_EQ(inputs.state(0), 0x0008);
+    CHECK_EQ(inputs.next_change(), 3);
+    CHECK_EQ(inputs.next_change(), 31);
+    CHECK_EQ(inputs.next_change(), -1);
+
+    // and open again
+    chain.faults(0, 0xFFFF)->faults(1, 0xFFFF);
+    samples(inputs, 4);
+    CHECK_EQ(inputs.state(0), 0);
+    CHECK_EQ(inputs.changes(0), 0x0008);
+    CHECK_EQ(inputs.changes(1), 0x8000);
+    CHECK_EQ(chain.detect_too_soon, 0);
+
+    inputs.end();
+    CHECK(!chain.special());
+    }
+
+TEST(scanner_rejects_bounce) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE, SDO);
+    chain.faults(0, 0xFFFF);
+    TLC5926 tlc;
+    tlc.attach(1, SDI, CLK, LE, OE, SDO);
+    TLC5926Scanner inputs;
+    inputs.attach(&tlc)->begin();
+
+    // closed, closed, open: the count starts over
+    chain.faults(0, 0xFFFE);
+    samples(inputs, 2);
+    chain.faults(0, 0xFFFF);
+    samples(inputs, 1);
+    chain.faults(0, 0xFFFE);
+    samples(inputs, 3);
+    CHECK_EQ(inputs.get(0), 0);
+    CHECK_EQ(inputs.next_change(), -1);
+    samples(inputs, 1);
+    CHECK_EQ(inputs.get(0), 1);
+    CHECK_EQ(inputs.next_change(), 0);
+
+    // a one-sample blip doesn't count either
+    chain.faults(0, 0xFFFF);
+    samples(inputs, 1);
+    chain.faults(0, 0xFFFE);
+    samples(inputs, 8);
+    CHECK_EQ(inputs.get(0), 1);
+    CHECK_EQ(inputs.next_change(), -1);
+    inputs.end();
+    }
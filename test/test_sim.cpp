@@ -0,0 +1,142 @@
+// The model itself, driven by hand: so the library tests are checking against the datasheet, not against themselves
+#include "test.h"
+
+static const int SDI = 2, CLK = 3, LE = 4, OE = 5, SDO = 6;
+
+static void clock_in(unsigned int bits, int ct) {
+    // MSB first, like the library
+    for (int i = ct - 1; i >= 0; i--) {
+        digitalWrite(SDI, (bits >> i) & 1);
+        digitalWrite(CLK, HIGH);
+        digitalWrite(CLK, LOW);
+        }
+    }
+
+static void latch() {
+    digitalWrite(LE, HIGH);
+    digitalWrite(LE, LOW);
+    }
+
+static void mode_switch(boolean special) {
+    // /OE 1,0,1,1,1 on the rises, LE high on the 4th for special
+    static const int oe[] = { HIGH, LOW, HIGH, HIGH, HIGH };
+    for (int i = 0; i < 5; i++) {
+        digitalWrite(OE, oe[i]);
+        digitalWrite(LE, special && i == 3);
+        digitalWrite(CLK, HIGH);
+        digitalWrite(CLK, LOW);
+        }
+    digitalWrite(LE, LOW);
+    }
+
+TEST(sim_shifts_first_chip_first) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE, SDO);
+    clock_in(0xABCD, 16);
+    clock_in(0x1234, 16);
+    CHECK_EQ(chain.shifted(0), 0x1234);
+    CHECK_EQ(chain.shifted(1), 0xABCD);
+    CHECK_EQ(chain.latched(0), 0);
+    CHECK_EQ(sim_pin(SDO), 1); // 0xABCD's MSB
+    CHECK_EQ(chain.clocks, 32);
+    CHECK_EQ(chain.setup_violations, 0);
+    }
+
+TEST(sim_latches_on_le_falling) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE);
+    clock_in(0x00F0, 16);
+    digitalWrite(LE, HIGH);
+    CHECK_EQ(chain.latched(0), 0);
+    digitalWrite(LE, LOW);
+    CHECK_EQ(chain.latched(0), 0x00F0);
+    CHECK_EQ(chain.output(4), HIGH);
+    CHECK_EQ(chain.output(3), LOW);
+    digitalWrite(OE, HIGH);
+    CHECK_EQ(chain.output(4), LOW); // off
+    CHECK_EQ(chain.latch_ct, 1);
+    }
+
+TEST(sim_le_tied_to_clk) {
+    TLC5926Sim chain(1, SDI, CLK);
+    clock_in(0x3, 2);
+    CHECK_EQ(chain.outputs(0), 0x3);
+    }
+
+TEST(sim_mixed_widths) {
+    TLC5926Sim chain(2, SDI, CLK, LE);
+    const byte bits[] = { 8, 16 };
+    chain.widths(bits);
+    CHECK_EQ(chain.channels(), 24);
+    clock_in(0xBEEF, 16);
+    clock_in(0x5A, 8);
+    latch();
+    CHECK_EQ(chain.latched(0), 0x5A);
+    CHECK_EQ(chain.latched(1), 0xBEEF);
+    CHECK_EQ(chain.output(8), HIGH); // chip 1's OUT0
+    }
+
+TEST(sim_config_mode) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE);
+    clock_in(0x0081, 16);
+    latch();
+    mode_switch(true);
+    CHECK(chain.special());
+    CHECK_EQ(chain.latch_ct, 1); // the mode switch's LE isn't a latch
+    clock_in(0x00C3, 16);
+    latch();
+    CHECK_EQ(chain.config(0), 0x00C3);
+    CHECK_EQ(chain.latched(0), 0x0081); // outputs keep their pattern
+    mode_switch(false);
+    CHECK(!chain.special());
+    CHECK_EQ(chain.mode_switches, 2);
+    }
+
+TEST(sim_error_detect) {
+    TLC5926Sim chain(2, SDI, CLK, LE, OE, SDO);
+    chain.faults(1, 0x8001);
+    clock_in(0xFFFF, 16);
+    clock_in(0xFFFF, 16);
+    latch();
+    mode_switch(true);
+    digitalWrite(OE, LOW);
+    for (int i = 0; i < 2; i++) clock_in(0, 1);
+    delayMicroseconds(2);
+    clock_in(0, 1);
+    digitalWrite(OE, HIGH);
+    CHECK_EQ(chain.status_loads, 1);
+    CHECK_EQ(chain.detect_too_soon, 0);
+    CHECK_EQ(chain.shifted(0), 0xFFFF);
+    CHECK_EQ(chain.shifted(1), 0x7FFE);
+    CHECK_EQ(sim_pin(SDO), 0); // chip 1's OUT15, open
+    }
+
+TEST(sim_error_detect_too_soon) {
+    TLC5926Sim chain(1, SDI, CLK, LE, OE, SDO);
+    mode_switch(true);
+    digitalWrite(OE, LOW);
+    for (int i = 0; i < 3; i++) clock_in(0, 1);
+    CHECK_EQ(chain.status_loads, 1);
+    CHECK_EQ(chain.detect_too_soon, 1);
+    }
+
+TEST(sim_counts_setup_violations) {
+    TLC5926Sim chain(1, SDI, CLK, LE);
+    // SDI and CLK in one port write: the chip gets the old SDI
+    sim_write((1ULL << SDI) | (1ULL << CLK), (1ULL << SDI) | (1ULL << CLK));
+    CHECK_EQ(chain.setup_violations, 1);
+    CHECK_EQ(chain.shifted(0), 0);
+    }
+
+TEST(sim_edges_and_time) {
+    digitalWrite(CLK, HIGH);
+    digitalWrite(CLK, HIGH); // no change, still costs
+    digitalWrite(CLK, LOW);
+    CHECK_EQ(sim_edges, 2);
+    CHECK_EQ(sim_writes, 3);
+    CHECK_EQ(sim_ns, 3 * sim_io_ns);
+    sim_drive(SDO, HIGH);
+    CHECK_EQ(sim_edges, 2); // the chip's, not ours
+    sim_trace(true);
+    digitalWrite(SDI, HIGH);
+    CHECK_EQ(sim_traced().size(), 1);
+    CHECK_EQ(sim_traced()[0].pin, SDI);
+    }
@@ -0,0 +1,114 @@
+// attach_spi(): the bytes that go to the SPI peripheral (byte-for-byte), and what the chain makes of them
+#include "test.h"
+#include <TLC5926SPI.h>
+#include <TLC5926.h>
+#include <SPI.h>
+
+static const int LE = 4, OE = 5;
+
+static boolean sent(const byte *bytes, int ct) {
+    if ((int) SPI.sent.size() != ct) return false;
+    for (int i = 0; i < ct; i++) {
+        if (SPI.sent[i] != bytes[i]) return false;
+        }
+    return true;
+    }
+
+TEST(spi_send_and_all) {
+    TLC5926Sim chain(2, MOSI, SCK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach_spi(2, LE, OE, -1, 8000000)->send(0x1234);
+    const byte word[] = { 0x12, 0x34 };
+    CHECK(sent(word, 2));
+    CHECK_EQ(SPI.settings.clock, 8000000);
+    CHECK_EQ(SPI.settings.bit_order, MSBFIRST);
+    CHECK_EQ(SPI.settings.data_mode, SPI_MODE0);
+    CHECK_EQ(chain.outputs(0), 0x1234);
+
+    SPI.sent.clear();
+    tlc.all(HIGH);
+    const byte ones[] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    CHECK(sent(ones, 4));
+    CHECK_EQ(chain.outputs(1), 0xFFFF);
+    CHECK_EQ(SPI.misuse, 0);
+    CHECK(!SPI.in_transaction);
+    }
+
+TEST(spi_flush_is_the_frame) {
+    TLC5926Sim chain(3, MOSI, SCK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach_spi(3, LE, OE);
+    tlc.set(0)->set(9)->set(47)->set_word(1, 0xC3A5)->flush();
+    CHECK(sent(tlc.frame(), tlc.frame_bytes()));
+    const byte want[] = { 0x80, 0x00, 0xC3, 0xA5, 0x02, 0x01 };
+    CHECK(sent(want, 6));
+    CHECK_EQ(chain.outputs(0), 0x0201);
+    CHECK_EQ(chain.outputs(1), 0xC3A5);
+    CHECK_EQ(chain.outputs(2), 0x8000);
+    CHECK_EQ(chain.latch_ct, 1);
+    CHECK_EQ(SPI.misuse, 0);
+
+    SPI.sent.clear();
+    tlc.flush(); // nothing changed
+    CHECK(SPI.sent.empty());
+    }
+
+TEST(spi_bit_bangs_the_rest) {
+    // config()/send_bits() take MOSI/SCK back, and the next shift hands them to SPI again
+    TLC5926Sim chain(2, MOSI, SCK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach_spi(2, LE, OE);
+    CHECK(SPI.enabled);
+    tlc.config(1, 0, 20);
+    CHECK(!SPI.enabled);
+    CHECK(SPI.sent.empty());
+    CHECK_EQ(chain.config(1), chain.config(0));
+    CHECK(chain.config(0) != 0);
+    tlc.send_bits(3, 0x5);
+    CHECK_EQ(chain.latched(0) & 0x7, 0x5); // (config() leaves /OE high)
+    tlc.send(0xBEEF);
+    CHECK(SPI.enabled);
+    CHECK_EQ(SPI.sent.size(), 2);
+    CHECK_EQ(chain.latched(0), 0xBEEF);
+    CHECK_EQ(SPI.misuse, 0);
+    }
+
+TEST(spi_verify_on_miso) {
+    TLC5926Sim chain(2, MOSI, SCK, LE, OE, MISO);
+    TLC5926 tlc;
+    tlc.attach_spi(2, LE, OE, MISO)->verify(true);
+    for (int i = 0; i < 4; i++) tlc.set(i * 5)->flush();
+    CHECK(tlc.verified());
+    CHECK_EQ(tlc.bit_errors(), 0);
+    }
+
+TEST(spi_async_frame) {
+    // no timer on the host: async_done() does a chunk each time it's asked
+    TLC5926Sim chain(2, MOSI, SCK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach_spi(2, LE, OE)->async_rate(100, 1);
+    const byte frame[] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    CHECK(tlc.send_async(frame));
+    int chunks = 0;
+    while (chunks < 10) {
+        chunks++;
+        if (tlc.async_done()) break;
+        }
+    CHECK_EQ(chunks, 4);
+    CHECK(sent(frame, 4));
+    CHECK_EQ(chain.outputs(0), 0xBEEF);
+    CHECK_EQ(chain.outputs(1), 0xDEAD);
+    CHECK_EQ(SPI.misuse, 0);
+    }
+
+TEST(spi_without_the_transport) {
+    // as if the sketch didn't include TLC5926SPI.h: same pins, bit-banged
+    TLC5926::spi_transport(NULL);
+    TLC5926Sim chain(1, MOSI, SCK, LE, OE);
+    TLC5926 tlc;
+    tlc.attach_spi(1, LE, OE)->send(0x0F0F);
+    CHECK(SPI.sent.empty());
+    CHECK(!SPI.enabled);
+    CHECK_EQ(chain.outputs(0), 0x0F0F);
+    TLC5926::spi_transport(TLC5926SPI::bus());
+    }
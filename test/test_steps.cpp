@@ -0,0 +1,111 @@
+// play_steps(): one port write per step (CLK, LE and /OE on one port, TLC5926_PORT_IO) against a write per pin.
+// The chips have to see the same thing either way: the same clocks with the same LE//OE/SDI, the same latches.
+#include "test.h"
+#include <TLC5926.h>
+
+// what the chips see, in order, from the edges: a CLK rise (with the levels before that write), LE falling, /OE
+enum { SEEN_CLOCK = 0x100, SEEN_LATCH = 0x200, SEEN_OE = 0x400 };
+
+static std::vector<int> seen(const std::vector<SimEdge> &edges, int sdi, int clk, int le, int oe, int levels) {
+    // levels: SDI/LE//OE at the start, bits 0/1/2
+    std::vector<int> events;
+    size_t i = 0;
+    while (i < edges.size()) {
+        int before = levels;
+        boolean rise = false, le_fell = false, oe_changed = false;
+        unsigned long write = edges[i].write;
+        for (; i < edges.size() && edges[i].write == write; i++) {
+            const SimEdge &e = edges[i];
+            int bit = e.pin == sdi ? 1 : e.pin == le ? 2 : e.pin == oe ? 4 : 0;
+            if (e.pin == clk && e.level) rise = true;
+            if (e.pin == le && !e.level) le_fell = true;
+            if (e.pin == oe) oe_changed = true;
+            if (bit) levels = e.level ? levels | bit : levels & ~bit;
+            }
+        if (rise) events.push_back(SEEN_CLOCK | before);
+        if (le_fell) events.push_back(SEEN_LATCH);
+        if (oe_changed) events.push_back(SEEN_OE | ((levels >> 2) & 1));
+        }
+    return events;
+    }
+
+struct Run {
+    std::vector<int> events;
+    unsigned long writes;
+    unsigned int config[2], status[2];
+    unsigned long mode_switches, status_loads, setup_violations, detect_too_soon;
+    };
+
+static Run run(int sdi, int clk, int le, int oe, int sdo) {
+    sim_reset();
+    Run r;
+    TLC5926Sim chain(2, sdi, clk, le, oe, sdo);
+    chain.faults(1, 0x0300);
+    TLC5926 tlc;
+    tlc.attach(2, sdi, clk, le, oe, sdo)->send(0x00FF);
+    sim_trace(true);
+    int levels = sim_pin(sdi) | sim_pin(le) << 1 | sim_pin(oe) << 2;
+    unsigned long writes = sim_writes;
+
+    tlc.config(1, 0, 42);
+    tlc.error_detect(r.status, 2);
+    tlc.detect_hold();
+    unsigned int again[2];
+    tlc.detect_sample(again, 2);
+    tlc.detect_release();
+    tlc.normal_mode()->on();
+
+    r.events = seen(sim_traced(), sdi, clk, le, oe, levels);
+    r.writes = sim_writes - writes;
+    r.config[0] = chain.config(0);
+    r.config[1] = chain.config(1);
+    r.mode_switches = chain.mode_switches;
+    r.status_loads = chain.status_loads;
+    r.setup_violations = chain.setup_violations;
+    r.detect_too_soon = chain.detect_too_soon;
+    CHECK_EQ(again[1], r.status[1]);
+    CHECK(!chain.special());
+    return r;
+    }
+
+TEST(steps_one_port_same_as_split) {
+    Run one = run(2, 3, 4, 5, 6); // CLK/LE//OE all on port 0
+    Run split = run(2, 11, 20, 29, 6);
+
+    CHECK_EQ(one.events.size(), split.events.size());
+    CHECK(one.events == split.events);
+    CHECK(one.events.size() > 50);
+    CHECK_EQ(one.config[0], split.config[0]);
+    CHECK_EQ(one.config[1], split.config[1]);
+    CHECK(one.config[0] != 0);
+    CHECK_EQ(one.status[0], 0xFFFF);
+    CHECK_EQ(one.status[1], 0xFCFF);
+    CHECK_EQ(split.status[1], 0xFCFF);
+    CHECK_EQ(one.mode_switches, split.mode_switches);
+    CHECK_EQ(one.status_loads, 3); // error_detect(), detect_hold(), detect_sample()
+    CHECK_EQ(split.status_loads, 3);
+    // a one-write step must not move LE or /OE on a CLK rise
+    CHECK_EQ(one.setup_violations, 0);
+    CHECK_EQ(split.setup_violations, 0);
+    CHECK_EQ(one.detect_too_soon, 0);
+    CHECK_EQ(split.detect_too_soon, 0);
+#if TLC5926_PORT_IO
+    CHECK(one.writes < split.writes); // it did take the one-write path
+#else
+    CHECK_EQ(one.writes, split.writes);
+#endif
+    }
+
+TEST(steps_patterns_hold_le_oe_over_clk) {
+    // so a step can be one write: LE//OE never change on the step that raises CLK
+    const byte *patterns[] = { NORMAL_MODE_PATTERN, SWITCH_MODE_PATTERN, ERROR_DETECT_MODE_PATTERN,
+        ERROR_DETECT_READY, ERROR_DETECT_AGAIN, CONFIGURATION_MODE_PATTERN };
+    for (unsigned int p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+        byte was = TLC5926_STEP(LOW, LOW, LOW);
+        for (const byte *at = patterns[p]; *at != TLC5926_STEP_END; at++) {
+            boolean rise = (*at & 1) && !(was & 1);
+            if (rise) CHECK_EQ((*at & 6) | p << 8, (was & 6) | p << 8);
+            was = *at;
+            }
+        }
+    }